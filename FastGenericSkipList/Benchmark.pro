@@ -0,0 +1,29 @@
+TEMPLATE = app
+CONFIG += console c++17 thread
+CONFIG -= app_bundle
+CONFIG -= qt
+
+TARGET = benchmark
+
+SOURCES += benchmark.cpp
+
+HEADERS += \
+    skiplist.h \
+    concurrentskiplist.h \
+    unrolledskiplist.h \
+    simdkeysearch.h \
+    levelgenerator.h \
+    frozenskiplist.h \
+    versionedskiplist.h \
+    augmentedskiplist.h \
+    expiringskiplist.h \
+    stringskiplist.h \
+    adaptiveskiplist.h
+
+# remove lower optimization flags
+QMAKE_CXXFLAGS_RELEASE -= -O
+QMAKE_CXXFLAGS_RELEASE -= -O1
+QMAKE_CXXFLAGS_RELEASE -= -O2
+
+# add full optimization
+QMAKE_CXXFLAGS_RELEASE *= -Ox
@@ -1,12 +1,22 @@
 TEMPLATE = app
-CONFIG += console c++11
+CONFIG += console c++17 thread
 CONFIG -= app_bundle
 CONFIG -= qt
 
 SOURCES += main.cpp
 
 HEADERS += \
-    skiplist.h
+    skiplist.h \
+    concurrentskiplist.h \
+    unrolledskiplist.h \
+    simdkeysearch.h \
+    levelgenerator.h \
+    frozenskiplist.h \
+    versionedskiplist.h \
+    augmentedskiplist.h \
+    expiringskiplist.h \
+    stringskiplist.h \
+    adaptiveskiplist.h
 
 # remove lower optimization flags
 QMAKE_CXXFLAGS_RELEASE -= -O
@@ -0,0 +1,28 @@
+TEMPLATE = app
+CONFIG += console c++17 thread
+CONFIG -= app_bundle
+CONFIG -= qt
+
+TARGET = regression
+
+SOURCES += regression.cpp
+
+HEADERS += \
+    skiplist.h \
+    concurrentskiplist.h \
+    unrolledskiplist.h \
+    versionedskiplist.h \
+    expiringskiplist.h \
+    simdkeysearch.h \
+    levelgenerator.h \
+    frozenskiplist.h
+
+# use-after-free and double frees have to fail loudly
+CONFIG += sanitizer sanitize_address sanitize_undefined
+
+# the tower layouts and key searches are picked at compile time, run one build per mode:
+# qmake CONFIG+=simd_towers CONFIG+=avx2 (vector kernels), CONFIG+=single_linked_towers, CONFIG+=no_simd (scalar kernels)
+simd_towers: DEFINES += SKIPLIST_SIMD_TOWERS
+single_linked_towers: DEFINES += SKIPLIST_SINGLE_LINKED_TOWERS
+no_simd: DEFINES += SKIPLIST_NO_SIMD
+avx2: QMAKE_CXXFLAGS += -mavx2
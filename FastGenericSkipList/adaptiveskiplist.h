@@ -0,0 +1,531 @@
+#ifndef ADAPTIVESKIPLIST_H
+#define ADAPTIVESKIPLIST_H
+
+#include <functional> // greater
+#include <iterator> // bidirectional_iterator_tag
+#include <utility> // pair, forward, piecewise_construct
+#include <tuple> // forward_as_tuple
+#include <cstdint> // uint32_t, uint64_t
+#include <cstddef> // size_t
+#include <new> // operator new, nothrow
+#include <algorithm> // min, max, copy
+#include <vector> // vector
+#include <stdexcept> // out_of_range
+
+#include "levelgenerator.h"
+
+
+/*
+ * skip list (unique keys) whose towers follow the lookups, for skewed (zipfian) access
+ * the heights are rolled at insertion as usual, then find() and lower_bound() count the lookups ending on every node.
+ * once a node's share of the lookups earns it more levels, it is promoted right away (the search just walked its path):
+ * a node hit by a fraction f of the lookups is raised to about log_{1/p}(1/f) levels under the top, so it is reached
+ * in O(log 1/f) steps instead of O(log n).
+ * decay() halves every count (lazily, nodes catch up when touched) and demotes the promoted nodes that cooled down,
+ * it only visits promoted nodes and runs on its own every ~size lookups. the promoted levels live in a small array
+ * next to the node (the rolled tower stays inline) and are capped at size / budgetShare + maxLevels in total.
+ * lookups restructure the list: find() and lower_bound() are not const, iterators stay valid.
+*/
+template <typename Key, typename T, class Compare = std::greater<Key>, class Levels = GeometricLevels<> > class AdaptiveSkipList
+{
+public:
+    struct Node
+    {
+        std::pair<Key, T> pair;
+        int height; // levels the node is linked on, rolled + promoted
+        int rolled; // levels of the inline tower
+        int slot = -1; // index in promoted, -1 if the node has no promoted levels
+        std::uint32_t hits = 0; // lookups that ended here, halved at every decay
+        std::uint32_t epoch = 0; // decay the hits were last brought up to
+        Node** extra = NULL; // promoted levels, next and prev side by side: [ next[rolled], prev[rolled], next[rolled+1], ... ]
+
+        template<class... Args>
+        Node(int level, Args&&... args) : pair(std::forward<Args>(args)...), height(level + 1), rolled(level + 1) { } // the pair is built in place from @args
+
+        // one allocation: [ Node | next[0 .. rolled-1] | prev[0 .. rolled-1] ]
+        Node** tower() { return reinterpret_cast<Node**>(reinterpret_cast<char*>(this) + towerOffset()); } // aray of ptrs
+        Node*& next(int i) { return i < rolled ? tower()[i] : extra[2 * (i - rolled)]; }
+        Node*& prev(int i) { return i < rolled ? tower()[rolled + i] : extra[2 * (i - rolled) + 1]; }
+
+        static constexpr std::size_t towerOffset() { return (sizeof(Node) + alignof(Node*) - 1) / alignof(Node*) * alignof(Node*); }
+        static std::size_t blockSize(int level) { return towerOffset() + 2 * (level + 1) * sizeof(Node*); }
+    };
+
+     // iterator implementation
+    class iterator
+    {
+        friend class AdaptiveSkipList;
+    private:
+        Node* it;
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef std::pair<Key, T> value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef std::pair<Key, T>* pointer;
+        typedef std::pair<Key, T>& reference;
+
+        iterator(Node* node = NULL) : it(node) { }
+        iterator operator++(int) { iterator old = *this; it = it->next(0); return old; }
+        iterator& operator++() { it = it->next(0); return *this; }
+        iterator operator--(int) { iterator old = *this; it = it->prev(0); return old; }
+        iterator& operator--() { it = it->prev(0); return *this; }
+        bool operator==(const iterator& other) const { return it == other.it; }
+        bool operator!=(const iterator& other) const { return it != other.it; }
+        std::pair<Key, T>& operator*() const { return it->pair; }
+        std::pair<Key, T>* operator->() const { return &it->pair; }
+    };
+
+    typedef int size_type;
+
+    AdaptiveSkipList(unsigned int maxLevels = 32, unsigned int budgetShare = 8); // promoted levels stay under size / @budgetShare + @maxLevels
+    AdaptiveSkipList(const AdaptiveSkipList&) = delete;
+    AdaptiveSkipList& operator=(const AdaptiveSkipList&) = delete;
+    ~AdaptiveSkipList();
+
+    // inserts only if no elt has an equivalent key, the value is built from @args
+    template<class... Args>
+    std::pair<iterator, bool> emplace(const Key& key, Args&&... args);
+    std::pair<iterator, bool> insert(const std::pair<Key, T>& pair);
+
+    iterator find(const Key& key); // counts the lookup, may promote the elt
+    iterator lower_bound(const Key& key); // counts the lookup on the elt found, may promote it
+    iterator upper_bound(const Key& key) const;
+    size_type count(const Key& key) const; // not counted as a lookup
+    iterator erase(const iterator it);
+    size_type erase(const Key& key);
+
+    void decay(); // halves the lookup counts, demotes the promoted nodes that cooled down; O(promoted nodes)
+
+    iterator begin() const;
+    iterator end() const;
+    bool empty() const;
+    size_type size() const;
+    size_type promoted_levels() const; // levels linked above the rolled towers
+    void clear();
+    void seed(std::uint64_t value); // reseeds the level generator
+
+private:
+    static constexpr int levelLimit = 64;
+    static constexpr std::uint32_t minHits = 8; // fewer lookups are noise, they never earn a level
+
+    template<class... Args>
+    static Node* createNode(int level, Args&&... args);
+    static void destroyNode(Node* node);
+    void init(); // sets up head and tail
+    void destroyNodes();
+
+    Node* search(const Key& key, Node** update, int& level) const; // first node whose key does not go before @key, see definition
+    void touch(Node* node, Node** update); // counts a lookup that ended on @node, promotes it if it earned it
+    void refresh(Node* node) const; // catches up with the decays @node missed
+    int targetHeight(Node* node) const; // height @node's lookups earn it, at least its rolled one
+    void promote(Node* node, int height, Node** update); // links @node on the levels up to @height, behind update[i]
+    void demote(Node* node, int height); // unlinks @node from the levels from @height up
+    void forget(Node* node); // drops @node from promoted
+
+    const int maxHeight; // max num of levels ("height")
+    const size_type budgetShare;
+    int currentHeight = 1; // current "height" of skip-list
+    size_type length = 0; // number of elts
+    Node* head; // head of skiplist
+    Node* tail; // tail of skiplist
+
+    std::vector<Node*> promoted; // nodes with promoted levels, decay() only looks at them
+    size_type promotedLevels = 0;
+    std::uint64_t accesses = 0; // lookups counted, halved at every decay like the hits
+    std::uint32_t epoch = 0; // decays so far
+
+    Levels levels; // rolls the node heights
+};
+
+/** implementation **/
+
+template<typename Key, typename T, class Compare, class Levels>
+AdaptiveSkipList<Key, T, Compare, Levels>::AdaptiveSkipList(unsigned int maxHeight, unsigned int budgetShare) : maxHeight(std::min<unsigned int>(std::max<unsigned int>(maxHeight, 1), levelLimit)), budgetShare(std::max<unsigned int>(budgetShare, 1)) // initialises a skiplist with the specified level height
+{
+    init();
+}
+
+template<typename Key, typename T, class Compare, class Levels>
+AdaptiveSkipList<Key, T, Compare, Levels>::~AdaptiveSkipList()
+{
+    destroyNodes();
+    destroyNode(head);
+    destroyNode(tail);
+}
+
+template<typename Key, typename T, class Compare, class Levels>
+void AdaptiveSkipList<Key, T, Compare, Levels>::init()
+{
+    head = createNode(maxHeight - 1);
+    tail = createNode(maxHeight - 1);
+
+    for (int i = 0; i != maxHeight; i++)
+    {
+        head->next(i) = tail;
+        head->prev(i) = NULL;
+        tail->next(i) = NULL;
+        tail->prev(i) = head;
+    }
+}
+
+template<typename Key, typename T, class Compare, class Levels>
+void AdaptiveSkipList<Key, T, Compare, Levels>::destroyNodes() // frees the elts, leaves head and tail alone
+{
+    Node* it = head->next(0);
+    while (it != tail)
+    {
+        Node* next = it->next(0);
+        destroyNode(it);
+        it = next;
+    }
+}
+
+template<typename Key, typename T, class Compare, class Levels>
+template<class... Args>
+typename AdaptiveSkipList<Key, T, Compare, Levels>::Node* AdaptiveSkipList<Key, T, Compare, Levels>::createNode(int level, Args&&... args) // allocates a node, its pair and its tower in one go
+{
+    void* block = ::operator new(Node::blockSize(level));
+    try
+    {
+        return new (block) Node(level, std::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+        ::operator delete(block);
+        throw;
+    }
+}
+
+template<typename Key, typename T, class Compare, class Levels>
+void AdaptiveSkipList<Key, T, Compare, Levels>::destroyNode(Node* node)
+{
+    delete[] node->extra;
+    node->~Node();
+    ::operator delete(node);
+}
+
+template<typename Key, typename T, class Compare, class Levels>
+typename AdaptiveSkipList<Key, T, Compare, Levels>::Node* AdaptiveSkipList<Key, T, Compare, Levels>::search(const Key& key, Node** update, int& level) const // stops on the first level the key itself shows up on (@level), update[i] is the node in front of the result on the levels above it (on all of them if the key is not there)
+{
+    Node* it = head; // our node iterator
+
+    // iterate over levels, from top to bottom
+    for (int i = currentHeight - 1; i >= 0; i--)
+    {
+        // iterate through the current level, from left to right, past the keys that go before @key
+        Node* next = it->next(i);
+        while (next != tail && Compare()(key, next->pair.first))
+        {
+            it = next;
+            next = it->next(i);
+        }
+        update[i] = it;
+
+        // met the key: it is the node's top level, the levels below only lead to it
+        if (next != tail && !Compare()(next->pair.first, key))
+        {
+            level = i;
+            return next;
+        }
+    }
+
+    level = 0;
+    return it->next(0);
+}
+
+template<typename Key, typename T, class Compare, class Levels>
+void AdaptiveSkipList<Key, T, Compare, Levels>::refresh(Node* node) const
+{
+    std::uint32_t missed = epoch - node->epoch;
+    node->hits = missed < 32 ? node->hits >> missed : 0;
+    node->epoch = epoch;
+}
+
+template<typename Key, typename T, class Compare, class Levels>
+int AdaptiveSkipList<Key, T, Compare, Levels>::targetHeight(Node* node) const
+{
+    if (node->hits < minHits)
+        return node->rolled;
+
+    // a share f = hits / accesses of the lookups is worth log_{1/p}(1/f) levels under the top
+    int below = (levelBitWidth(accesses / node->hits) + Levels::log2Inverse - 1) / Levels::log2Inverse;
+    return std::max(node->rolled, std::min(currentHeight, currentHeight + 1 - below));
+}
+
+template<typename Key, typename T, class Compare, class Levels>
+void AdaptiveSkipList<Key, T, Compare, Levels>::touch(Node* node, Node** update)
+{
+    refresh(node);
+    node->hits++;
+
+    // the counts cover the last ~2 * size lookups
+    if (++accesses >= 2 * static_cast<std::uint64_t>(length) + 4096)
+    {
+        decay();
+        return;
+    }
+
+    // cheap pretest for targetHeight(node) > node->height: accesses / hits < (1/p)^(levels above the node)
+    int shift = (currentHeight - node->height) * Levels::log2Inverse;
+    if (node->hits >= minHits && shift > 0 && (shift >= 32 || (static_cast<std::uint64_t>(node->hits) << shift) > accesses))
+        promote(node, targetHeight(node), update);
+}
+
+template<typename Key, typename T, class Compare, class Levels>
+void AdaptiveSkipList<Key, T, Compare, Levels>::promote(Node* node, int height, Node** update)
+{
+    height = std::min(height, node->height + (length / budgetShare + maxHeight - promotedLevels));
+    if (height <= node->height)
+        return;
+
+    // a lookup does not throw for want of memory, the node just stays where it is
+    Node** extra = new (std::nothrow) Node*[2 * (height - node->rolled)];
+    if (extra == NULL)
+        return;
+    if (node->extra != NULL)
+    {
+        std::copy(node->extra, node->extra + 2 * (node->height - node->rolled), extra);
+        delete[] node->extra;
+    }
+    node->extra = extra;
+
+    // rebind the pointers
+    for (int i = node->height; i != height; i++)
+    {
+        Node* left = update[i];
+        node->next(i) = left->next(i);
+        node->prev(i) = left;
+        left->next(i)->prev(i) = node;
+        left->next(i) = node;
+    }
+
+    if (node->slot < 0)
+    {
+        node->slot = static_cast<int>(promoted.size());
+        promoted.push_back(node);
+    }
+    promotedLevels += height - node->height;
+    node->height = height;
+}
+
+template<typename Key, typename T, class Compare, class Levels>
+void AdaptiveSkipList<Key, T, Compare, Levels>::demote(Node* node, int height)
+{
+    if (height >= node->height)
+        return;
+
+    for (int i = height; i != node->height; i++)
+    {
+        node->prev(i)->next(i) = node->next(i);
+        node->next(i)->prev(i) = node->prev(i);
+    }
+
+    promotedLevels -= node->height - height;
+    node->height = height;
+    if (height == node->rolled)
+    {
+        forget(node);
+        delete[] node->extra;
+        node->extra = NULL;
+    }
+}
+
+template<typename Key, typename T, class Compare, class Levels>
+void AdaptiveSkipList<Key, T, Compare, Levels>::forget(Node* node)
+{
+    Node* last = promoted.back();
+    promoted[node->slot] = last;
+    last->slot = node->slot;
+    promoted.pop_back();
+    node->slot = -1;
+}
+
+template<typename Key, typename T, class Compare, class Levels>
+void AdaptiveSkipList<Key, T, Compare, Levels>::decay()
+{
+    epoch++;
+    accesses /= 2;
+
+    // backwards: forget() moves the last node into the freed slot, that one was looked at already
+    for (std::size_t i = promoted.size(); i-- != 0; )
+    {
+        Node* node = promoted[i];
+        refresh(node);
+        demote(node, targetHeight(node));
+    }
+}
+
+template<typename Key, typename T, class Compare, class Levels>
+template<class... Args>
+std::pair<typename AdaptiveSkipList<Key, T, Compare, Levels>::iterator, bool> AdaptiveSkipList<Key, T, Compare, Levels>::emplace(const Key& key, Args&&... args)
+{
+    Node* update[levelLimit];
+    int level;
+    Node* found = search(key, update, level);
+    if (found != tail && !Compare()(found->pair.first, key))
+        return std::make_pair(iterator(found), false);
+
+    int lvl = cappedLevel(levels, length, maxHeight);
+    Node* newNode = createNode(lvl, std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...)); // creation
+    newNode->epoch = epoch;
+    for (; currentHeight <= lvl; currentHeight++)
+        update[currentHeight] = head;
+
+    // rebind the pointers
+    for (int i = 0; i <= lvl; i++)
+    {
+        Node* left = update[i];
+        newNode->next(i) = left->next(i);
+        newNode->prev(i) = left;
+        left->next(i)->prev(i) = newNode;
+        left->next(i) = newNode;
+    }
+
+    length++;
+    return std::make_pair(iterator(newNode), true);
+}
+
+template<typename Key, typename T, class Compare, class Levels>
+std::pair<typename AdaptiveSkipList<Key, T, Compare, Levels>::iterator, bool> AdaptiveSkipList<Key, T, Compare, Levels>::insert(const std::pair<Key, T>& pair)
+{
+    return emplace(pair.first, pair.second);
+}
+
+template<typename Key, typename T, class Compare, class Levels>
+typename AdaptiveSkipList<Key, T, Compare, Levels>::iterator AdaptiveSkipList<Key, T, Compare, Levels>::find(const Key& key) // returns an iterator to the element with @key, end() otherwise
+{
+    Node* update[levelLimit];
+    int level;
+    Node* it = search(key, update, level);
+    if (it == tail || Compare()(it->pair.first, key))
+        return tail;
+
+    touch(it, update);
+    return it;
+}
+
+template<typename Key, typename T, class Compare, class Levels>
+typename AdaptiveSkipList<Key, T, Compare, Levels>::iterator AdaptiveSkipList<Key, T, Compare, Levels>::lower_bound(const Key& key) // first elt whose key does not go before @key
+{
+    Node* update[levelLimit];
+    int level;
+    Node* it = search(key, update, level);
+    if (it != tail)
+        touch(it, update); // update[] covers the levels above it, whether the key was met or not
+    return it;
+}
+
+template<typename Key, typename T, class Compare, class Levels>
+typename AdaptiveSkipList<Key, T, Compare, Levels>::iterator AdaptiveSkipList<Key, T, Compare, Levels>::upper_bound(const Key& key) const // first elt whose key goes after @key
+{
+    Node* update[levelLimit];
+    int level;
+    Node* it = search(key, update, level);
+    if (it != tail && !Compare()(it->pair.first, key))
+        it = it->next(0);
+    return it;
+}
+
+template<typename Key, typename T, class Compare, class Levels>
+typename AdaptiveSkipList<Key, T, Compare, Levels>::size_type AdaptiveSkipList<Key, T, Compare, Levels>::count(const Key& key) const
+{
+    Node* update[levelLimit];
+    int level;
+    Node* it = search(key, update, level);
+    return it != tail && !Compare()(it->pair.first, key) ? 1 : 0;
+}
+
+template<typename Key, typename T, class Compare, class Levels>
+typename AdaptiveSkipList<Key, T, Compare, Levels>::iterator AdaptiveSkipList<Key, T, Compare, Levels>::erase(const iterator it) // removes the node from the container, returns the next node
+{
+    // we don't want to bite off our head or tail :)
+    Node* node = it.it;
+    if (node == head || node == tail)
+        throw std::out_of_range("argument iterator does not point to a valid node");
+
+    // rebind pointers, promoted levels included
+    for (int i = 0; i != node->height; i++)
+    {
+        node->prev(i)->next(i) = node->next(i);
+        node->next(i)->prev(i) = node->prev(i);
+    }
+
+    if (node->slot >= 0)
+    {
+        promotedLevels -= node->height - node->rolled;
+        forget(node);
+    }
+
+    Node* next = node->next(0);
+    destroyNode(node);
+    length--;
+    return next;
+}
+
+template<typename Key, typename T, class Compare, class Levels>
+typename AdaptiveSkipList<Key, T, Compare, Levels>::size_type AdaptiveSkipList<Key, T, Compare, Levels>::erase(const Key& key) // removes the node with @key, returns the number of elts removed
+{
+    Node* update[levelLimit];
+    int level;
+    Node* it = search(key, update, level);
+    if (it == tail || Compare()(it->pair.first, key))
+        return 0;
+
+    erase(iterator(it));
+    return 1;
+}
+
+template<typename Key, typename T, class Compare, class Levels>
+typename AdaptiveSkipList<Key, T, Compare, Levels>::iterator AdaptiveSkipList<Key, T, Compare, Levels>::begin() const // return start iterator of level 0
+{
+    return head->next(0);
+}
+
+template<typename Key, typename T, class Compare, class Levels>
+typename AdaptiveSkipList<Key, T, Compare, Levels>::iterator AdaptiveSkipList<Key, T, Compare, Levels>::end() const // return past-the-end iterator of level 0
+{
+    return tail;
+}
+
+template<typename Key, typename T, class Compare, class Levels>
+bool AdaptiveSkipList<Key, T, Compare, Levels>::empty() const
+{
+    return length == 0;
+}
+
+template<typename Key, typename T, class Compare, class Levels>
+typename AdaptiveSkipList<Key, T, Compare, Levels>::size_type AdaptiveSkipList<Key, T, Compare, Levels>::size() const
+{
+    return length;
+}
+
+template<typename Key, typename T, class Compare, class Levels>
+typename AdaptiveSkipList<Key, T, Compare, Levels>::size_type AdaptiveSkipList<Key, T, Compare, Levels>::promoted_levels() const
+{
+    return promotedLevels;
+}
+
+template<typename Key, typename T, class Compare, class Levels>
+void AdaptiveSkipList<Key, T, Compare, Levels>::clear() // removes all elts
+{
+    destroyNodes();
+    for (int i = 0; i != maxHeight; i++)
+    {
+        head->next(i) = tail;
+        tail->prev(i) = head;
+    }
+
+    promoted.clear();
+    promotedLevels = 0;
+    accesses = 0;
+    currentHeight = 1;
+    length = 0;
+}
+
+template<typename Key, typename T, class Compare, class Levels>
+void AdaptiveSkipList<Key, T, Compare, Levels>::seed(std::uint64_t value)
+{
+    levels.seed(value);
+}
+
+#endif // ADAPTIVESKIPLIST_H
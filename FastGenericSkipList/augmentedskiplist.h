@@ -0,0 +1,561 @@
+#ifndef AUGMENTEDSKIPLIST_H
+#define AUGMENTEDSKIPLIST_H
+
+#include <functional> // greater
+#include <iterator> // bidirectional_iterator_tag
+#include <utility> // pair, forward
+#include <cstdint> // uint64_t
+#include <new> // operator new, align_val_t
+#include <cstddef> // size_t
+#include <limits> // numeric_limits
+#include <algorithm> // min, max
+#include <stdexcept> // out_of_range
+
+#include "levelgenerator.h"
+
+
+/*
+ * monoids for AugmentedSkipList: a value_type with an identity and an associative combine(), and lift(), the value
+ * of one elt. combine() does not have to be commutative, the elts are always combined in list order.
+*/
+template<typename T> struct SumOf
+{
+    typedef T value_type;
+    static value_type identity() { return T(); }
+    static value_type combine(const value_type& a, const value_type& b) { return a + b; }
+    template<typename Key> static value_type lift(const Key&, const T& value) { return value; }
+};
+
+template<typename T> struct MinOf
+{
+    typedef T value_type;
+    static value_type identity() { return std::numeric_limits<T>::max(); }
+    static value_type combine(const value_type& a, const value_type& b) { return b < a ? b : a; }
+    template<typename Key> static value_type lift(const Key&, const T& value) { return value; }
+};
+
+template<typename T> struct MaxOf
+{
+    typedef T value_type;
+    static value_type identity() { return std::numeric_limits<T>::lowest(); }
+    static value_type combine(const value_type& a, const value_type& b) { return a < b ? b : a; }
+    template<typename Key> static value_type lift(const Key&, const T& value) { return value; }
+};
+
+struct CountOf
+{
+    typedef std::size_t value_type;
+    static value_type identity() { return 0; }
+    static value_type combine(value_type a, value_type b) { return a + b; }
+    template<typename Key, typename T> static value_type lift(const Key&, const T&) { return 1; }
+};
+
+/*
+ * augmented skip list: every link of a tower also holds the elts it covers combined with a Monoid, which gives
+ * aggregate(lo, hi) (sum, min, max, ... of the elts with a key in [lo, hi)) in O(log n) instead of a scan.
+ * same multimap semantics as SkipList for emplace, emplace_hint, find, bounds and erase; the sums of the links
+ * jumping over a changed elt are recomputed bottom-up from the level below, O(log n) per change.
+ * values can't be changed through an iterator (the sums would go stale), assign() does it.
+*/
+template <typename Key, typename T, class Monoid = SumOf<T>, class Compare = std::greater<Key>, class Levels = GeometricLevels<> > class AugmentedSkipList
+{
+public:
+    typedef typename Monoid::value_type aggregate_type;
+
+    struct Node
+    {
+        std::pair<Key, T> pair;
+        int height; // height of this node
+
+        template<class... Args>
+        Node(int level, Args&&... args) : pair(std::forward<Args>(args)...), height(level + 1) { }
+
+        // the tower lives inline, right behind the node: [ Node | next[0 .. height-1] | prev[0 .. height-1] | sums[0 .. height-1] ]
+        Node** next() { return reinterpret_cast<Node**>(reinterpret_cast<char*>(this) + towerOffset()); } // aray of ptrs
+        Node** prev() { return next() + height; } // aray of ptrs
+        aggregate_type* sums() { return reinterpret_cast<aggregate_type*>(reinterpret_cast<char*>(this) + sumsOffset(height)); } // sums[i]: this elt up to next[i] (excluded) combined
+
+        static constexpr std::size_t towerOffset() { return (sizeof(Node) + alignof(Node*) - 1) / alignof(Node*) * alignof(Node*); }
+        static std::size_t sumsOffset(int height) { return (towerOffset() + 2 * height * sizeof(Node*) + alignof(aggregate_type) - 1) / alignof(aggregate_type) * alignof(aggregate_type); }
+        static std::size_t blockSize(int level) { return sumsOffset(level + 1) + (level + 1) * sizeof(aggregate_type); } // bytes needed for a node of this level
+    };
+
+    // iterator implementation (elts are read-only, see assign())
+    class iterator
+    {
+        friend class AugmentedSkipList;
+    private:
+        Node* it;
+    public:
+        iterator(Node* node = NULL) : it(node) { }
+        iterator operator++(int) { iterator old = *this; it = it->next()[0]; return old; }
+        iterator& operator++() { it = it->next()[0]; return *this; }
+        iterator operator--(int) { iterator old = *this; it = it->prev()[0]; return old; }
+        iterator& operator--() { it = it->prev()[0]; return *this; }
+        bool operator==(const iterator& other) const { return it == other.it; }
+        bool operator!=(const iterator& other) const { return it != other.it; }
+        const std::pair<Key, T>& operator*() const { return it->pair; }
+        const std::pair<Key, T>* operator->() const { return &it->pair; }
+
+        // iterator traits
+        using difference_type = std::ptrdiff_t;
+        using value_type = std::pair<Key, T>;
+        using pointer = const std::pair<Key, T>*;
+        using reference = const std::pair<Key, T>&;
+        using iterator_category = std::bidirectional_iterator_tag;
+    };
+
+    typedef int size_type;
+
+    AugmentedSkipList(unsigned int maxLevels = 32);
+    AugmentedSkipList(const AugmentedSkipList&) = delete;
+    AugmentedSkipList& operator=(const AugmentedSkipList&) = delete;
+    ~AugmentedSkipList();
+
+    template<class... Args>
+    iterator emplace(Args&&... args); // the elt is constructed in place from the arguments
+    iterator insert(const std::pair<Key, T>& pair);
+    iterator insert(std::pair<Key, T>&& pair);
+    template<class... Args>
+    iterator emplace_hint(const iterator position, Args&&... args);
+    iterator insert(const iterator position, const std::pair<Key, T>& pair);
+
+    iterator find(const Key& key) const;
+    iterator lower_bound(const Key& key) const;
+    iterator upper_bound(const Key& key) const;
+    size_type count(const Key& key) const;
+    iterator erase(const iterator it);
+    size_type erase(const Key& key);
+    void assign(const iterator it, const T& value); // replaces the value of the elt @it points to, O(log n)
+
+    aggregate_type aggregate(const Key& lo, const Key& hi) const; // the elts with a key in [lo, hi) combined, O(log n)
+    aggregate_type aggregate() const; // all elts combined
+
+    iterator begin() const;
+    iterator end() const;
+    bool empty() const;
+    size_type size() const;
+    void clear();
+    void seed(std::uint64_t value); // reseeds the level generator
+
+private:
+    static constexpr int levelLimit = 64;
+
+    template<class... Args>
+    static Node* createNode(int level, Args&&... args);
+    static void destroyNode(Node* node);
+    void init(); // sets up head and tail
+    void destroyNodes();
+
+    void growHeight(int level); // makes the list at least @level + 1 levels high
+    Node* descend(const Key& key, bool upper, Node** update) const; // returns the node in front of the lower (upper) bound, fills update[i] (if given) with the node we left level i from
+    void predecessors(Node* node, Node** update) const; // the last node in front of @node on every level, climbing back from it
+    Node* link(Node* newNode, Node* const* update); // links @newNode behind update[i] on every level, fixes the sums
+    void unlink(Node* node, Node* const* update); // takes @node (right behind update[i] on its levels) out, fixes the sums
+    void resum(Node* node, int level); // recomputes node->sums()[level] from the level below
+
+    const int maxHeight; // max num of levels ("height")
+    int currentHeight = 1; // current "height" of skip-list
+    size_type length = 0; // number of elts
+    Node* head; // head of skiplist
+    Node* tail; // tail of skiplist
+
+    Levels levels; // rolls the node heights
+};
+
+/** implementation **/
+
+template<typename Key, typename T, class Monoid, class Compare, class Levels>
+AugmentedSkipList<Key, T, Monoid, Compare, Levels>::AugmentedSkipList(unsigned int maxHeight) : maxHeight(std::min<unsigned int>(std::max<unsigned int>(maxHeight, 1), levelLimit)) // initialises a skiplist with the specified level height
+{
+    init();
+}
+
+template<typename Key, typename T, class Monoid, class Compare, class Levels>
+AugmentedSkipList<Key, T, Monoid, Compare, Levels>::~AugmentedSkipList()
+{
+    destroyNodes();
+    destroyNode(head);
+    destroyNode(tail);
+}
+
+template<typename Key, typename T, class Monoid, class Compare, class Levels>
+void AugmentedSkipList<Key, T, Monoid, Compare, Levels>::init()
+{
+    head = createNode(maxHeight - 1);
+    tail = createNode(maxHeight - 1);
+
+    for (int i = 0; i != maxHeight; i++)
+    {
+        head->next()[i] = tail;
+        head->prev()[i] = NULL;
+        tail->next()[i] = NULL;
+        tail->prev()[i] = head;
+    }
+}
+
+template<typename Key, typename T, class Monoid, class Compare, class Levels>
+void AugmentedSkipList<Key, T, Monoid, Compare, Levels>::destroyNodes() // frees the elts, leaves head and tail alone
+{
+    Node* it = head->next()[0];
+    while (it != tail)
+    {
+        Node* next = it->next()[0];
+        destroyNode(it);
+        it = next;
+    }
+}
+
+template<typename Key, typename T, class Monoid, class Compare, class Levels>
+template<class... Args>
+typename AugmentedSkipList<Key, T, Monoid, Compare, Levels>::Node* AugmentedSkipList<Key, T, Monoid, Compare, Levels>::createNode(int level, Args&&... args) // allocates a node, its pair and its tower in one go; the sums start as the identity
+{
+    void* block = ::operator new(Node::blockSize(level), std::align_val_t(64));
+    Node* node;
+    try
+    {
+        node = new (block) Node(level, std::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+        ::operator delete(block, std::align_val_t(64));
+        throw;
+    }
+
+    for (int i = 0; i != node->height; i++)
+        new (&node->sums()[i]) aggregate_type(Monoid::identity());
+    return node;
+}
+
+template<typename Key, typename T, class Monoid, class Compare, class Levels>
+void AugmentedSkipList<Key, T, Monoid, Compare, Levels>::destroyNode(Node* node)
+{
+    for (int i = 0; i != node->height; i++)
+        node->sums()[i].~aggregate_type();
+    node->~Node();
+    ::operator delete(node, std::align_val_t(64));
+}
+
+template<typename Key, typename T, class Monoid, class Compare, class Levels>
+void AugmentedSkipList<Key, T, Monoid, Compare, Levels>::growHeight(int level) // only once the new node exists, a fresh level's sum is set by link()
+{
+    if (level >= currentHeight)
+        currentHeight = level + 1;
+}
+
+template<typename Key, typename T, class Monoid, class Compare, class Levels>
+typename AugmentedSkipList<Key, T, Monoid, Compare, Levels>::Node* AugmentedSkipList<Key, T, Monoid, Compare, Levels>::descend(const Key& key, bool upper, Node** update) const
+{
+    Node* it = head; // our node iterator
+    // iterate over levels, from top to bottom
+    for (int i = currentHeight - 1; i >= 0; i--)
+    {
+        // iterate through the current level, from left to right, past the keys that go before @key (upper: do not go after it)
+        for (Node* next = it->next()[i]; next != tail && (upper ? !Compare()(next->pair.first, key) : Compare()(key, next->pair.first)); next = it->next()[i])
+            it = next;
+
+        if (update != NULL)
+            update[i] = it;
+    }
+
+    return it;
+}
+
+template<typename Key, typename T, class Monoid, class Compare, class Levels>
+void AugmentedSkipList<Key, T, Monoid, Compare, Levels>::predecessors(Node* node, Node** update) const
+{
+    update[0] = node->prev()[0];
+    for (int i = 1; i < currentHeight; i++)
+    {
+        if (i < node->height)
+        {
+            update[i] = node->prev()[i];
+            continue;
+        }
+
+        // climb to the last node in front of @node that is high enough
+        Node* left = update[i - 1];
+        while (left->height <= i)
+            left = left->prev()[i - 1];
+        update[i] = left;
+    }
+}
+
+template<typename Key, typename T, class Monoid, class Compare, class Levels>
+void AugmentedSkipList<Key, T, Monoid, Compare, Levels>::resum(Node* node, int level)
+{
+    aggregate_type sum = node->sums()[level - 1];
+    for (Node* it = node->next()[level - 1]; it != node->next()[level]; it = it->next()[level - 1])
+        sum = Monoid::combine(sum, it->sums()[level - 1]);
+    node->sums()[level] = sum;
+}
+
+template<typename Key, typename T, class Monoid, class Compare, class Levels>
+typename AugmentedSkipList<Key, T, Monoid, Compare, Levels>::Node* AugmentedSkipList<Key, T, Monoid, Compare, Levels>::link(Node* newNode, Node* const* update)
+{
+    // rebind the pointers
+    for (int i = 0; i != newNode->height; i++)
+    {
+        Node* left = update[i];
+        newNode->next()[i] = left->next()[i];
+        left->next()[i] = newNode;
+
+        newNode->prev()[i] = left;
+        newNode->next()[i]->prev()[i] = newNode;
+    }
+
+    // bottom-up, every level is summed from the one below: the links in front of the new node got shorter
+    // (or now jump over it), the ones of the new node are fresh
+    newNode->sums()[0] = Monoid::lift(newNode->pair.first, newNode->pair.second);
+    for (int i = 1; i < currentHeight; i++)
+    {
+        resum(update[i], i);
+        if (i < newNode->height)
+            resum(newNode, i);
+    }
+
+    length++;
+    return newNode;
+}
+
+template<typename Key, typename T, class Monoid, class Compare, class Levels>
+void AugmentedSkipList<Key, T, Monoid, Compare, Levels>::unlink(Node* node, Node* const* update)
+{
+    // rebind pointers
+    for (int i = 0; i != node->height; i++)
+    {
+        update[i]->next()[i] = node->next()[i];
+        node->next()[i]->prev()[i] = update[i];
+    }
+
+    // the links that covered the node lost it (or now take over its links), level 0 sums are single elts
+    for (int i = 1; i < currentHeight; i++)
+        resum(update[i], i);
+
+    length--;
+}
+
+template<typename Key, typename T, class Monoid, class Compare, class Levels>
+template<class... Args>
+typename AugmentedSkipList<Key, T, Monoid, Compare, Levels>::iterator AugmentedSkipList<Key, T, Monoid, Compare, Levels>::emplace(Args&&... args) // inserts the new elt behind the elts with an equivalent key
+{
+    Node* update[levelLimit];
+    int lvl = cappedLevel(levels, length, maxHeight);
+    Node* newNode = createNode(lvl, std::forward<Args>(args)...); // creation
+    growHeight(lvl);
+    descend(newNode->pair.first, true, update);
+    return link(newNode, update);
+}
+
+template<typename Key, typename T, class Monoid, class Compare, class Levels>
+typename AugmentedSkipList<Key, T, Monoid, Compare, Levels>::iterator AugmentedSkipList<Key, T, Monoid, Compare, Levels>::insert(const std::pair<Key, T>& pair)
+{
+    return emplace(pair);
+}
+
+template<typename Key, typename T, class Monoid, class Compare, class Levels>
+typename AugmentedSkipList<Key, T, Monoid, Compare, Levels>::iterator AugmentedSkipList<Key, T, Monoid, Compare, Levels>::insert(std::pair<Key, T>&& pair)
+{
+    return emplace(std::move(pair));
+}
+
+template<typename Key, typename T, class Monoid, class Compare, class Levels>
+template<class... Args>
+typename AugmentedSkipList<Key, T, Monoid, Compare, Levels>::iterator AugmentedSkipList<Key, T, Monoid, Compare, Levels>::emplace_hint(const iterator position, Args&&... args) // inserts right in front of @position if the order allows it (no search), like emplace() otherwise
+{
+    Node* update[levelLimit];
+    int lvl = cappedLevel(levels, length, maxHeight);
+    Node* newNode = createNode(lvl, std::forward<Args>(args)...); // creation
+    growHeight(lvl);
+
+    Node* right = position.it;
+    Node* left = right->prev()[0];
+    const Key& key = newNode->pair.first;
+    if ((right == tail || !Compare()(key, right->pair.first)) && (left == head || !Compare()(left->pair.first, key)))
+    {
+        // climb back from @left to the last node high enough for every level
+        update[0] = left;
+        for (int i = 1; i < currentHeight; i++)
+        {
+            Node* it = update[i - 1];
+            while (it->height <= i)
+                it = it->prev()[i - 1];
+            update[i] = it;
+        }
+    }
+    else
+    {
+        descend(key, true, update);
+    }
+
+    return link(newNode, update);
+}
+
+template<typename Key, typename T, class Monoid, class Compare, class Levels>
+typename AugmentedSkipList<Key, T, Monoid, Compare, Levels>::iterator AugmentedSkipList<Key, T, Monoid, Compare, Levels>::insert(const iterator position, const std::pair<Key, T>& pair)
+{
+    return emplace_hint(position, pair);
+}
+
+template<typename Key, typename T, class Monoid, class Compare, class Levels>
+typename AugmentedSkipList<Key, T, Monoid, Compare, Levels>::iterator AugmentedSkipList<Key, T, Monoid, Compare, Levels>::find(const Key& key) const // returns an iterator to the first element with a key equivalent to @key, end() otherwise
+{
+    Node* it = descend(key, false, NULL)->next()[0];
+    if (it != tail && !Compare()(it->pair.first, key))
+        return it;
+    return tail;
+}
+
+template<typename Key, typename T, class Monoid, class Compare, class Levels>
+typename AugmentedSkipList<Key, T, Monoid, Compare, Levels>::iterator AugmentedSkipList<Key, T, Monoid, Compare, Levels>::lower_bound(const Key& key) const // first elt whose key does not go before @key
+{
+    return descend(key, false, NULL)->next()[0];
+}
+
+template<typename Key, typename T, class Monoid, class Compare, class Levels>
+typename AugmentedSkipList<Key, T, Monoid, Compare, Levels>::iterator AugmentedSkipList<Key, T, Monoid, Compare, Levels>::upper_bound(const Key& key) const // first elt whose key goes after @key
+{
+    return descend(key, true, NULL)->next()[0];
+}
+
+template<typename Key, typename T, class Monoid, class Compare, class Levels>
+typename AugmentedSkipList<Key, T, Monoid, Compare, Levels>::size_type AugmentedSkipList<Key, T, Monoid, Compare, Levels>::count(const Key& key) const // O(log n + count)
+{
+    size_type count = 0;
+    for (Node* it = descend(key, false, NULL)->next()[0]; it != tail && !Compare()(it->pair.first, key); it = it->next()[0])
+        count++;
+    return count;
+}
+
+template<typename Key, typename T, class Monoid, class Compare, class Levels>
+typename AugmentedSkipList<Key, T, Monoid, Compare, Levels>::iterator AugmentedSkipList<Key, T, Monoid, Compare, Levels>::erase(const iterator it) // removes the node from the container, returns the next node
+{
+    // we don't want to bite off our head or tail :)
+    if (it.it == head || it.it == tail)
+        throw std::out_of_range("argument iterator does not point to a valid node");
+
+    Node* update[levelLimit];
+    predecessors(it.it, update);
+    unlink(it.it, update);
+
+    Node* next = it.it->next()[0];
+    destroyNode(it.it);
+    return next;
+}
+
+template<typename Key, typename T, class Monoid, class Compare, class Levels>
+typename AugmentedSkipList<Key, T, Monoid, Compare, Levels>::size_type AugmentedSkipList<Key, T, Monoid, Compare, Levels>::erase(const Key& key) // removes all the nodes with @key, returns the number of elts removed
+{
+    Node* update[levelLimit];
+    descend(key, false, update);
+
+    // the run of equal keys is right behind update[0], the path in front of it stays valid while we take it apart
+    size_type count = 0;
+    for (Node* it = update[0]->next()[0]; it != tail && !Compare()(it->pair.first, key); it = update[0]->next()[0])
+    {
+        unlink(it, update);
+        destroyNode(it);
+        count++;
+    }
+
+    return count;
+}
+
+template<typename Key, typename T, class Monoid, class Compare, class Levels>
+void AugmentedSkipList<Key, T, Monoid, Compare, Levels>::assign(const iterator it, const T& value)
+{
+    Node* node = it.it;
+    node->pair.second = value;
+    node->sums()[0] = Monoid::lift(node->pair.first, value);
+
+    // the node's own links and the ones jumping over it, bottom-up
+    Node* update[levelLimit];
+    predecessors(node, update);
+    for (int i = 1; i < currentHeight; i++)
+        resum(i < node->height ? node : update[i], i);
+}
+
+template<typename Key, typename T, class Monoid, class Compare, class Levels>
+typename AugmentedSkipList<Key, T, Monoid, Compare, Levels>::aggregate_type AugmentedSkipList<Key, T, Monoid, Compare, Levels>::aggregate(const Key& lo, const Key& hi) const
+{
+    aggregate_type sum = Monoid::identity();
+    if (!Compare()(hi, lo))
+        return sum; // empty range
+
+    Node* it = descend(lo, false, NULL)->next()[0];
+    Node* end = descend(hi, false, NULL)->next()[0];
+
+    // from the first elt of the range always take the highest link that does not jump past its end: climbing while
+    // the towers grow, coming down towards the end, O(log n) links like a search
+    auto inside = [&](Node* node) { return node == end || (node != tail && Compare()(hi, node->pair.first)); };
+    int i = 0;
+    while (it != end)
+    {
+        while (i + 1 < it->height && inside(it->next()[i + 1]))
+            i++;
+        while (i > 0 && !inside(it->next()[i]))
+            i--;
+
+        sum = Monoid::combine(sum, it->sums()[i]);
+        it = it->next()[i];
+    }
+
+    return sum;
+}
+
+template<typename Key, typename T, class Monoid, class Compare, class Levels>
+typename AugmentedSkipList<Key, T, Monoid, Compare, Levels>::aggregate_type AugmentedSkipList<Key, T, Monoid, Compare, Levels>::aggregate() const // head's top link and the few other links on the top level
+{
+    int top = currentHeight - 1;
+    aggregate_type sum = head->sums()[top];
+    for (Node* it = head->next()[top]; it != tail; it = it->next()[top])
+        sum = Monoid::combine(sum, it->sums()[top]);
+    return sum;
+}
+
+template<typename Key, typename T, class Monoid, class Compare, class Levels>
+typename AugmentedSkipList<Key, T, Monoid, Compare, Levels>::iterator AugmentedSkipList<Key, T, Monoid, Compare, Levels>::begin() const // return start iterator of level 0
+{
+    return head->next()[0];
+}
+
+template<typename Key, typename T, class Monoid, class Compare, class Levels>
+typename AugmentedSkipList<Key, T, Monoid, Compare, Levels>::iterator AugmentedSkipList<Key, T, Monoid, Compare, Levels>::end() const // return past-the-end iterator of level 0
+{
+    return tail;
+}
+
+template<typename Key, typename T, class Monoid, class Compare, class Levels>
+bool AugmentedSkipList<Key, T, Monoid, Compare, Levels>::empty() const
+{
+    return length == 0;
+}
+
+template<typename Key, typename T, class Monoid, class Compare, class Levels>
+typename AugmentedSkipList<Key, T, Monoid, Compare, Levels>::size_type AugmentedSkipList<Key, T, Monoid, Compare, Levels>::size() const
+{
+    return length;
+}
+
+template<typename Key, typename T, class Monoid, class Compare, class Levels>
+void AugmentedSkipList<Key, T, Monoid, Compare, Levels>::clear() // removes all elts
+{
+    destroyNodes();
+    for (int i = 0; i != maxHeight; i++)
+    {
+        head->next()[i] = tail;
+        tail->prev()[i] = head;
+        head->sums()[i] = Monoid::identity();
+    }
+
+    currentHeight = 1;
+    length = 0;
+}
+
+template<typename Key, typename T, class Monoid, class Compare, class Levels>
+void AugmentedSkipList<Key, T, Monoid, Compare, Levels>::seed(std::uint64_t value)
+{
+    levels.seed(value);
+}
+
+#endif // AUGMENTEDSKIPLIST_H
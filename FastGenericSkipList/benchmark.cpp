@@ -0,0 +1,569 @@
+#include <iostream>
+#include <iomanip> // setw, setprecision
+#include <sstream>
+#include <random> // mt19937_64, uniform_int_distribution
+#include <map>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <algorithm> // nth_element, min, max
+#include <cmath> // pow
+#include <cstdio> // snprintf
+#include <cstring> // strncpy
+#include <cstdint> // uint64_t
+#include "skiplist.h"
+#include "concurrentskiplist.h"
+#include "unrolledskiplist.h"
+#include "adaptiveskiplist.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define BENCHMARK_FORK // every run gets a process of its own, so its peak RSS is its own
+#include <unistd.h> // fork, pipe
+#include <sys/wait.h> // waitpid
+#include <sys/resource.h> // getrusage
+#endif
+
+/*
+ * benchmark suite: fills every container with --size keys, then runs --ops operations of a read/write mix on it
+ * usage: benchmark [--size=N] [--ops=N] [--containers=multimap,skiplist,skiplist-p4,unrolled,adaptive,concurrent]
+ *                  [--keys=int,double,string] [--dists=uniform,zipfian,sequential,clustered] [--reads=90,...]
+ *                  [--threads=1,...] [--sample=N] [--seed=N] [--format=text|csv|json]
+ * every combination of the lists is one run. reads are find()s, writes are half insertions of new keys, half erase(key).
+ * sequential reads walk the keys in order, zipfian reads (theta 0.99) hit a few keys most of the time.
+ * adaptive (AdaptiveSkipList) keeps unique keys: a new key that is already in is not inserted twice.
+ * with more than one thread the containers that are not thread-safe are guarded by a mutex ("+mutex").
+ * latency percentiles come from every --sample-th operation (they include the cost of reading the clock).
+*/
+
+using namespace std;
+
+struct Config
+{
+    long size = 1000000;
+    long ops = -1; // same as size
+    vector<string> containers = { "multimap", "skiplist", "skiplist-p4", "unrolled", "adaptive", "concurrent" };
+    vector<string> keys = { "int" };
+    vector<string> dists = { "uniform", "zipfian", "sequential", "clustered" };
+    vector<int> reads = { 90 };
+    vector<int> threads = { 1 };
+    int sample = 8;
+    uint64_t seed = 1;
+    string format = "text";
+};
+
+struct Result // plain old data, so a forked run can hand it back through a pipe
+{
+    char container[32];
+    char key[16];
+    char dist[16];
+    long size;
+    long ops;
+    int reads;
+    int threads;
+    double fillNs; // per insertion, filling the container
+    double mixNs; // per operation of the mix
+    double p50, p90, p99, p999; // latency of the mix operations, ns
+    long hits; // successful finds, keeps the reads from being optimised away
+    long peakRssKb; // -1 if unknown
+    long rssGrowthKb; // peak RSS minus the RSS before the container was built
+    bool ok;
+};
+
+static string buildFlags() // compile-time modes of the headers, they change the SkipList layout
+{
+    string flags;
+#if defined(SKIPLIST_SIMD_TOWERS)
+    flags += "simd_towers ";
+#endif
+#if defined(SKIPLIST_SINGLE_LINKED_TOWERS)
+    flags += "single_linked ";
+#endif
+#if defined(SKIPLIST_NO_SIMD)
+    flags += "no_simd ";
+#endif
+    if (flags.empty())
+        return "default";
+    flags.pop_back();
+    return flags;
+}
+
+static long peakRssKb()
+{
+#if defined(BENCHMARK_FORK)
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+    return usage.ru_maxrss / 1024; // bytes on macOS
+#else
+    return usage.ru_maxrss;
+#endif
+#else
+    return -1;
+#endif
+}
+
+/** keys **/
+
+template<typename Key> Key makeKey(uint64_t raw);
+template<> int makeKey<int>(uint64_t raw) { return static_cast<int>(raw & 0x7fffffff); }
+template<> double makeKey<double>(uint64_t raw) { return static_cast<double>(raw & 0x7fffffff) / 3.0; }
+template<> string makeKey<string>(uint64_t raw) // "user" + 16 digits, too long for the small string buffer (like YCSB keys)
+{
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "user%016llu", static_cast<unsigned long long>(raw & 0x7fffffff));
+    return buffer;
+}
+
+class Zipfian // YCSB's zipfian generator over [0, n), rank 0 is the most popular
+{
+public:
+    Zipfian(long n, double theta = 0.99) : n(n), theta(theta)
+    {
+        for (long i = 1; i <= n; i++)
+            zetan += 1.0 / pow(static_cast<double>(i), theta);
+        double zeta2 = 1.0 + 1.0 / pow(2.0, theta);
+        alpha = 1.0 / (1.0 - theta);
+        eta = (1.0 - pow(2.0 / n, 1.0 - theta)) / (1.0 - zeta2 / zetan);
+    }
+
+    long operator()(double u) // @u uniform in [0, 1)
+    {
+        double uz = u * zetan;
+        if (uz < 1.0)
+            return 0;
+        if (uz < 1.0 + pow(0.5, theta))
+            return 1;
+        return min<long>(n - 1, static_cast<long>(n * pow(eta * u - eta + 1.0, alpha)));
+    }
+
+private:
+    long n;
+    double theta;
+    double zetan = 0.0;
+    double alpha;
+    double eta;
+};
+
+struct Workload // everything the timed loops need, generated up front
+{
+    vector<uint64_t> fill; // keys in the container before the mix
+    vector<uint64_t> extra; // new keys for the insertions of the mix
+    vector<unsigned char> kind; // per operation: 0 find, 1 insert, 2 erase
+    vector<long> target; // per operation: index into fill (find, erase) or extra (insert)
+};
+
+static Workload makeWorkload(const string& dist, long size, long ops, int reads, uint64_t seed)
+{
+    Workload work;
+    mt19937_64 generator(seed);
+    uniform_int_distribution<uint64_t> raw(0, 0x7fffffff);
+    uniform_real_distribution<double> unit(0.0, 1.0);
+
+    // keys
+    vector<uint64_t> centers; // clustered: 64 narrow ranges spread over the key space
+    if (dist == "clustered")
+        for (int c = 0; c != 64; c++)
+            centers.push_back(raw(generator) & ~uint64_t(0xfffff));
+    auto draw = [&](long i) -> uint64_t
+    {
+        if (dist == "sequential")
+            return static_cast<uint64_t>(i) * 2; // ascending, the extra keys go behind the filled ones
+        if (dist == "clustered")
+            return centers[generator() % centers.size()] + (generator() & 0xffff);
+        return raw(generator);
+    };
+    work.fill.resize(size);
+    for (long i = 0; i != size; i++)
+        work.fill[i] = draw(i);
+    work.extra.resize(ops);
+    for (long i = 0; i != ops; i++)
+        work.extra[i] = draw(size + i);
+
+    // operations
+    Zipfian* zipfian = dist == "zipfian" ? new Zipfian(size) : NULL;
+    work.kind.resize(ops);
+    work.target.resize(ops);
+    long writes = 0;
+    for (long i = 0; i != ops; i++)
+    {
+        bool read = static_cast<int>(generator() % 100) < reads;
+        work.kind[i] = read ? 0 : (writes++ % 2 == 0 ? 1 : 2);
+
+        if (work.kind[i] == 1)
+            work.target[i] = i; // a new key
+        else if (dist == "sequential")
+            work.target[i] = i % size; // a walk through the keys, in order
+        else if (zipfian != NULL)
+            work.target[i] = (*zipfian)(unit(generator)); // fill is random, so the popular ranks are spread over the key space
+        else
+            work.target[i] = static_cast<long>(generator() % size);
+    }
+    delete zipfian;
+
+    return work;
+}
+
+/** containers **/
+
+template<typename Key, class Container>
+struct SingleThreaded // adapter for the containers with a multimap interface
+{
+    static constexpr bool threadSafe = false;
+    Container container;
+
+    void insert(const Key& key) { container.emplace(key, 0); }
+    bool find(const Key& key) { return container.find(key) != container.end(); }
+    void erase(const Key& key) { container.erase(key); }
+};
+
+template<typename Key>
+struct Concurrent
+{
+    static constexpr bool threadSafe = true;
+    ConcurrentSkipList<Key, int> container;
+
+    void insert(const Key& key) { container.emplace(key, 0); }
+    bool find(const Key& key) { return container.find(key) != container.end(); }
+    void erase(const Key& key) { container.erase(key); }
+};
+
+template<class Work>
+void runThreads(unsigned int threadCount, Work work) // runs work(threadIndex) on @threadCount threads, waits for all of them
+{
+    vector<thread> threads;
+    for (unsigned int t = 0; t != threadCount; t++)
+        threads.emplace_back(work, t);
+    for (thread& t : threads)
+        t.join();
+}
+
+template<typename Key, class Adapter>
+Result measure(const Config& config, const string& dist, int reads, int threadCount) // one run: fill, then the mix
+{
+    const long ops = config.ops < 0 ? config.size : config.ops;
+    Workload work = makeWorkload(dist, config.size, ops, reads, config.seed);
+
+    // key objects are built outside the timed loops
+    vector<Key> fill(work.fill.size());
+    for (size_t i = 0; i != fill.size(); i++)
+        fill[i] = makeKey<Key>(work.fill[i]);
+    vector<Key> extra(work.extra.size());
+    for (size_t i = 0; i != extra.size(); i++)
+        extra[i] = makeKey<Key>(work.extra[i]);
+    work.fill.clear();
+    work.fill.shrink_to_fit();
+    work.extra.clear();
+    work.extra.shrink_to_fit();
+    if (dist == "sequential")
+        sort(fill.begin(), fill.end()); // already are for int; doubles and strings follow the same order
+
+    Result result = Result();
+    long rssBefore = peakRssKb();
+    Adapter* adapter = new Adapter();
+    mutex lock;
+    const bool locked = threadCount > 1 && !Adapter::threadSafe;
+
+    // fill
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    runThreads(threadCount, [&](unsigned int t)
+    {
+        for (long i = t; i < config.size; i += threadCount)
+        {
+            if (locked)
+            {
+                lock_guard<mutex> guard(lock);
+                adapter->insert(fill[i]);
+            }
+            else
+            {
+                adapter->insert(fill[i]);
+            }
+        }
+    });
+    chrono::steady_clock::time_point end = chrono::steady_clock::now();
+    result.fillNs = chrono::duration<double, nano>(end - start).count() / max<long>(config.size, 1);
+
+    // mix
+    vector<vector<double> > latencies(threadCount);
+    vector<long> hits(threadCount, 0);
+    start = chrono::steady_clock::now();
+    runThreads(threadCount, [&](unsigned int t)
+    {
+        vector<double>& samples = latencies[t];
+        samples.reserve(ops / threadCount / config.sample + 1);
+        long found = 0;
+        for (long i = t; i < ops; i += threadCount)
+        {
+            bool sampled = (i / threadCount) % config.sample == 0;
+            chrono::steady_clock::time_point opStart;
+            if (sampled)
+                opStart = chrono::steady_clock::now();
+
+            {
+                unique_lock<mutex> guard(lock, defer_lock);
+                if (locked)
+                    guard.lock();
+
+                switch (work.kind[i])
+                {
+                case 0: found += adapter->find(fill[work.target[i]]); break;
+                case 1: adapter->insert(extra[work.target[i]]); break;
+                default: adapter->erase(fill[work.target[i]]); break;
+                }
+            }
+
+            if (sampled)
+                samples.push_back(chrono::duration<double, nano>(chrono::steady_clock::now() - opStart).count());
+        }
+        hits[t] = found;
+    });
+    end = chrono::steady_clock::now();
+    result.mixNs = chrono::duration<double, nano>(end - start).count() / max<long>(ops, 1);
+
+    // percentiles over the samples of all threads
+    vector<double> all;
+    for (const vector<double>& samples : latencies)
+        all.insert(all.end(), samples.begin(), samples.end());
+    auto percentile = [&](double p) -> double
+    {
+        if (all.empty())
+            return 0.0;
+        size_t index = min(all.size() - 1, static_cast<size_t>(p * all.size()));
+        nth_element(all.begin(), all.begin() + index, all.end());
+        return all[index];
+    };
+    result.p50 = percentile(0.50);
+    result.p90 = percentile(0.90);
+    result.p99 = percentile(0.99);
+    result.p999 = percentile(0.999);
+
+    for (long h : hits)
+        result.hits += h;
+    result.peakRssKb = peakRssKb();
+    result.rssGrowthKb = result.peakRssKb >= 0 ? result.peakRssKb - rssBefore : -1;
+    delete adapter;
+
+    result.size = config.size;
+    result.ops = ops;
+    result.reads = reads;
+    result.threads = threadCount;
+    result.ok = true;
+    return result;
+}
+
+template<typename Key>
+Result measureContainer(const Config& config, const string& container, const string& dist, int reads, int threadCount)
+{
+    if (container == "multimap")
+        return measure<Key, SingleThreaded<Key, multimap<Key, int> > >(config, dist, reads, threadCount);
+    if (container == "skiplist")
+        return measure<Key, SingleThreaded<Key, SkipList<Key, int> > >(config, dist, reads, threadCount);
+    if (container == "skiplist-p4")
+        return measure<Key, SingleThreaded<Key, SkipList<Key, int, greater<Key>, allocator<pair<Key, int> >, GeometricLevels<2> > > >(config, dist, reads, threadCount);
+    if (container == "unrolled")
+        return measure<Key, SingleThreaded<Key, UnrolledSkipList<Key, int> > >(config, dist, reads, threadCount);
+    if (container == "adaptive")
+        return measure<Key, SingleThreaded<Key, AdaptiveSkipList<Key, int> > >(config, dist, reads, threadCount);
+    if (container == "concurrent")
+        return measure<Key, Concurrent<Key> >(config, dist, reads, threadCount);
+
+    Result result = Result();
+    result.ok = false;
+    return result;
+}
+
+static Result measureOne(const Config& config, const string& container, const string& key, const string& dist, int reads, int threadCount)
+{
+    Result result = Result();
+    if (key == "int")
+        result = measureContainer<int>(config, container, dist, reads, threadCount);
+    else if (key == "double")
+        result = measureContainer<double>(config, container, dist, reads, threadCount);
+    else if (key == "string")
+        result = measureContainer<string>(config, container, dist, reads, threadCount);
+
+    string name = container;
+    if (threadCount > 1 && container != "concurrent")
+        name += "+mutex";
+    strncpy(result.container, name.c_str(), sizeof(result.container) - 1);
+    strncpy(result.key, key.c_str(), sizeof(result.key) - 1);
+    strncpy(result.dist, dist.c_str(), sizeof(result.dist) - 1);
+    return result;
+}
+
+static Result run(const Config& config, const string& container, const string& key, const string& dist, int reads, int threadCount) // in a child process if we can
+{
+#if defined(BENCHMARK_FORK)
+    int channel[2];
+    if (pipe(channel) == 0)
+    {
+        pid_t child = fork();
+        if (child == 0)
+        {
+            close(channel[0]);
+            Result result = measureOne(config, container, key, dist, reads, threadCount);
+            ssize_t written = write(channel[1], &result, sizeof(result));
+            _exit(written == sizeof(result) ? 0 : 1);
+        }
+
+        close(channel[1]);
+        Result result = Result();
+        size_t got = 0;
+        while (child > 0 && got < sizeof(result))
+        {
+            ssize_t n = read(channel[0], reinterpret_cast<char*>(&result) + got, sizeof(result) - got);
+            if (n <= 0)
+                break;
+            got += n;
+        }
+        close(channel[0]);
+        if (child > 0)
+            waitpid(child, NULL, 0);
+        if (got == sizeof(result))
+            return result;
+    }
+#endif
+    return measureOne(config, container, key, dist, reads, threadCount);
+}
+
+/** output **/
+
+static void printHeader(const Config& config)
+{
+    if (config.format == "csv")
+    {
+        cout << "container,key,dist,size,ops,reads,threads,build,fill_ns,mix_ns,p50_ns,p90_ns,p99_ns,p999_ns,hits,peak_rss_kb,rss_growth_kb" << endl;
+    }
+    else if (config.format == "json")
+    {
+        cout << "[" << endl;
+    }
+    else
+    {
+        cout << "build: " << buildFlags() << endl;
+        cout << left << setw(20) << "container" << setw(8) << "key" << setw(12) << "dist" << right << setw(7) << "reads" << setw(8) << "threads"
+             << setw(10) << "fill ns" << setw(10) << "mix ns" << setw(10) << "p50" << setw(10) << "p90" << setw(10) << "p99" << setw(10) << "p99.9"
+             << setw(12) << "peak KB" << setw(12) << "growth KB" << endl;
+    }
+}
+
+static void printResult(const Config& config, const Result& result, bool first)
+{
+    cout << fixed << setprecision(1);
+    if (config.format == "csv")
+    {
+        cout << result.container << "," << result.key << "," << result.dist << "," << result.size << "," << result.ops << "," << result.reads << ","
+             << result.threads << "," << buildFlags() << "," << result.fillNs << "," << result.mixNs << "," << result.p50 << "," << result.p90 << ","
+             << result.p99 << "," << result.p999 << "," << result.hits << "," << result.peakRssKb << "," << result.rssGrowthKb << endl;
+    }
+    else if (config.format == "json")
+    {
+        cout << (first ? "  {" : ",\n  {")
+             << "\"container\": \"" << result.container << "\", \"key\": \"" << result.key << "\", \"dist\": \"" << result.dist << "\", "
+             << "\"size\": " << result.size << ", \"ops\": " << result.ops << ", \"reads\": " << result.reads << ", \"threads\": " << result.threads << ", "
+             << "\"build\": \"" << buildFlags() << "\", \"fill_ns\": " << result.fillNs << ", \"mix_ns\": " << result.mixNs << ", "
+             << "\"p50_ns\": " << result.p50 << ", \"p90_ns\": " << result.p90 << ", \"p99_ns\": " << result.p99 << ", \"p999_ns\": " << result.p999 << ", "
+             << "\"hits\": " << result.hits << ", \"peak_rss_kb\": " << result.peakRssKb << ", \"rss_growth_kb\": " << result.rssGrowthKb << "}" << flush;
+    }
+    else
+    {
+        cout << left << setw(20) << result.container << setw(8) << result.key << setw(12) << result.dist << right << setw(7) << result.reads << setw(8) << result.threads
+             << setw(10) << result.fillNs << setw(10) << result.mixNs << setw(10) << result.p50 << setw(10) << result.p90 << setw(10) << result.p99 << setw(10) << result.p999
+             << setw(12) << result.peakRssKb << setw(12) << result.rssGrowthKb << endl;
+    }
+}
+
+static void printFooter(const Config& config)
+{
+    if (config.format == "json")
+        cout << "\n]" << endl;
+}
+
+/** command line **/
+
+static vector<string> splitList(const string& list)
+{
+    vector<string> items;
+    stringstream stream(list);
+    string item;
+    while (getline(stream, item, ','))
+        if (!item.empty())
+            items.push_back(item);
+    return items;
+}
+
+static vector<int> splitInts(const string& list)
+{
+    vector<int> items;
+    for (const string& item : splitList(list))
+        items.push_back(stoi(item));
+    return items;
+}
+
+static bool parse(int argc, char* argv[], Config& config)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        size_t equals = arg.find('=');
+        if (arg.compare(0, 2, "--") != 0 || equals == string::npos)
+            return false;
+        string name = arg.substr(2, equals - 2);
+        string value = arg.substr(equals + 1);
+
+        if (name == "size") config.size = stol(value);
+        else if (name == "ops") config.ops = stol(value);
+        else if (name == "containers") config.containers = splitList(value);
+        else if (name == "keys") config.keys = splitList(value);
+        else if (name == "dists") config.dists = splitList(value);
+        else if (name == "reads") config.reads = splitInts(value);
+        else if (name == "threads") config.threads = splitInts(value);
+        else if (name == "sample") config.sample = max(1, stoi(value));
+        else if (name == "seed") config.seed = stoull(value);
+        else if (name == "format") config.format = value;
+        else return false;
+    }
+    return config.size > 0;
+}
+
+int main(int argc, char *argv[])
+{
+    Config config;
+    try
+    {
+        if (!parse(argc, argv, config))
+        {
+            cerr << "usage: " << argv[0] << " [--size=N] [--ops=N] [--containers=multimap,skiplist,skiplist-p4,unrolled,adaptive,concurrent] [--keys=int,double,string]"
+                 << " [--dists=uniform,zipfian,sequential,clustered] [--reads=90,...] [--threads=1,...] [--sample=N] [--seed=N] [--format=text|csv|json]" << endl;
+            return 1;
+        }
+    }
+    catch (const exception&)
+    {
+        cerr << "invalid number in the arguments" << endl;
+        return 1;
+    }
+
+    printHeader(config);
+    bool first = true;
+    for (int threadCount : config.threads)
+        for (int reads : config.reads)
+            for (const string& key : config.keys)
+                for (const string& dist : config.dists)
+                    for (const string& container : config.containers)
+                    {
+                        Result result = run(config, container, key, dist, reads, max(threadCount, 1));
+                        if (!result.ok)
+                        {
+                            cerr << "skipped: " << container << " / " << key << " / " << dist << " (unknown name)" << endl;
+                            continue;
+                        }
+                        printResult(config, result, first);
+                        first = false;
+                    }
+    printFooter(config);
+
+    return 0;
+}
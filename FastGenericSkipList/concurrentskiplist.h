@@ -0,0 +1,714 @@
+#ifndef CONCURRENTSKIPLIST_H
+#define CONCURRENTSKIPLIST_H
+
+#include <functional> // greater
+#include <iterator> // forward_iterator_tag
+#include <utility> // pair, swap
+#include <random> // random_device
+#include <atomic> // atomic
+#include <cstdint> // uintptr_t, uint64_t
+#include <cstddef> // size_t
+#include <new> // operator new, align_val_t
+#include <vector> // vector
+#include <algorithm> // min, max
+#include <thread> // hardware_concurrency
+
+#include "levelgenerator.h"
+
+
+/*
+ * epoch based memory reclamation
+ * a thread "pins" itself while it is touching shared nodes, unlinked nodes are "retired" and only freed once every
+ * pinned thread has moved past the epoch they were retired in
+ *
+ * there is a single domain per process, shared by every ConcurrentSkipList (retired nodes carry their own deleter,
+ * so they can outlive the list they were unlinked from)
+*/
+class EpochReclaimer
+{
+private:
+    struct Record;
+
+public:
+    typedef void (*Deleter)(void*);
+
+    class Guard // RAII pin; guards are bound to the thread that created them
+    {
+    public:
+        Guard() : record(EpochReclaimer::pin()) { }
+        Guard(std::nullptr_t) : record(NULL) { } // empty guard, pins nothing
+        Guard(const Guard& other) : record(other.record) { if (record != NULL) EpochReclaimer::repin(record); }
+        Guard(Guard&& other) : record(other.record) { other.record = NULL; }
+        Guard& operator=(Guard other) { std::swap(record, other.record); return *this; }
+        ~Guard() { if (record != NULL) EpochReclaimer::unpin(record); }
+
+    private:
+        Record* record;
+    };
+
+    static void retire(void* pointer, Deleter deleter) // hands an unlinked object over for deferred destruction
+    {
+        Record* record = local();
+        record->retired.push_back(Retired{ pointer, deleter, globalEpoch().load() });
+        if (record->retired.size() >= collectThreshold)
+        {
+            tryAdvance();
+            collect(record);
+        }
+    }
+
+private:
+    struct Retired
+    {
+        void* pointer;
+        Deleter deleter;
+        std::uint64_t epoch; // epoch the object was retired in
+    };
+
+    struct Record // per thread state, records are never freed but get reused by new threads
+    {
+        std::atomic<std::uint64_t> epoch{ idle };
+        std::atomic<bool> active{ true };
+        unsigned int nesting = 0; // pins held by the owning thread
+        std::vector<Retired> retired;
+        Record* next = NULL;
+    };
+
+    struct ThreadHandle
+    {
+        Record* record;
+
+        ThreadHandle() : record(acquire()) { }
+        ~ThreadHandle()
+        {
+            collect(record); // leftovers are adopted by the next thread that takes this record
+            record->active.store(false, std::memory_order_release);
+        }
+    };
+
+    static constexpr std::uint64_t idle = ~std::uint64_t(0); // epoch of an unpinned thread
+    static constexpr std::size_t collectThreshold = 128; // retired objects per thread before we try to free some
+
+    static std::atomic<std::uint64_t>& globalEpoch() { static std::atomic<std::uint64_t> epoch{ 0 }; return epoch; }
+    static std::atomic<Record*>& records() { static std::atomic<Record*> head{ NULL }; return head; }
+    static Record* local() { thread_local ThreadHandle handle; return handle.record; }
+
+    static Record* acquire() // takes over an inactive record or registers a new one
+    {
+        for (Record* it = records().load(std::memory_order_acquire); it != NULL; it = it->next)
+        {
+            bool expected = false;
+            if (!it->active.load(std::memory_order_relaxed) && it->active.compare_exchange_strong(expected, true, std::memory_order_acquire))
+                return it;
+        }
+
+        Record* record = new Record();
+        Record* head = records().load(std::memory_order_relaxed);
+        do
+        {
+            record->next = head;
+        } while (!records().compare_exchange_weak(head, record, std::memory_order_release, std::memory_order_relaxed));
+
+        return record;
+    }
+
+    static Record* pin()
+    {
+        Record* record = local();
+        repin(record);
+        return record;
+    }
+
+    static void repin(Record* record)
+    {
+        if (record->nesting++ != 0)
+            return; // already pinned
+
+        // announce the current epoch, make sure it did not move while we were announcing it
+        std::uint64_t epoch = globalEpoch().load();
+        while (true)
+        {
+            record->epoch.store(epoch);
+            std::uint64_t now = globalEpoch().load();
+            if (now == epoch)
+                break;
+            epoch = now;
+        }
+    }
+
+    static void unpin(Record* record)
+    {
+        if (--record->nesting == 0)
+            record->epoch.store(idle, std::memory_order_release);
+    }
+
+    static void tryAdvance() // moves the global epoch forward, if every pinned thread has seen the current one
+    {
+        std::uint64_t epoch = globalEpoch().load();
+        for (Record* it = records().load(std::memory_order_acquire); it != NULL; it = it->next)
+        {
+            std::uint64_t recordEpoch = it->epoch.load();
+            if (recordEpoch != idle && recordEpoch != epoch)
+                return;
+        }
+
+        globalEpoch().compare_exchange_strong(epoch, epoch + 1);
+    }
+
+    static void collect(Record* record) // frees everything that was retired at least two epochs ago
+    {
+        std::uint64_t epoch = globalEpoch().load();
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i != record->retired.size(); i++)
+        {
+            Retired& retired = record->retired[i];
+            if (retired.epoch + 2 <= epoch)
+                retired.deleter(retired.pointer);
+            else
+                record->retired[kept++] = retired;
+        }
+
+        record->retired.resize(kept);
+    }
+};
+
+
+/*
+ * lock-free skip list (Harris/Fraser style)
+ * multimap semantics like SkipList: find/lower_bound/upper_bound never block, emplace links the levels bottom-up
+ * with CAS and erase marks a node's links top-down (the level 0 mark is the logical deletion) before unlinking it
+ * iterators pin the calling thread (see EpochReclaimer), so nodes they point to stay readable even if they get erased
+ * elts with equal keys are in insertion order on level 0 only, the upper levels may hold them in another order (a tower
+ * is linked behind the equal keys present when each of its levels goes in); nothing relies on their order up there,
+ * a node is unlinked by identity, walking the whole run of its key on every level
+*/
+template <typename Key, typename T, class Compare = std::greater<Key> > class ConcurrentSkipList
+{
+public:
+    struct Node
+    {
+        std::pair<Key, T> pair;
+        int height; // height of this node
+        std::atomic<int> pending; // the inserter and the eraser both have to let go of the node before it is retired
+
+        Node(int level) : pair(), height(level + 1), pending(2) { initTower(); }
+        Node(const Key& key, const T& value, int level) : pair(key, value), height(level + 1), pending(2) { initTower(); }
+
+        // inline tower, the lowest bit of a link marks the node that owns it as deleted (at that level)
+        std::atomic<std::uintptr_t>* next() { return reinterpret_cast<std::atomic<std::uintptr_t>*>(reinterpret_cast<char*>(this) + towerOffset()); }
+
+        static constexpr std::size_t towerOffset() { return (sizeof(Node) + alignof(std::atomic<std::uintptr_t>) - 1) / alignof(std::atomic<std::uintptr_t>) * alignof(std::atomic<std::uintptr_t>); }
+        static std::size_t blockSize(int level) { return towerOffset() + (level + 1) * sizeof(std::atomic<std::uintptr_t>); } // bytes needed for a node of this level
+
+    private:
+        void initTower()
+        {
+            for (int i = 0; i != height; i++)
+                new (&next()[i]) std::atomic<std::uintptr_t>(0);
+        }
+    };
+
+    // iterator implementation (forward only, skips erased nodes)
+    class iterator
+    {
+        friend class ConcurrentSkipList;
+    private:
+        Node* it;
+        EpochReclaimer::Guard guard;
+
+        iterator(Node* node, EpochReclaimer::Guard&& guard) : it(node), guard(std::move(guard)) { }
+    public:
+        iterator() : it(NULL), guard(nullptr) { }
+        iterator operator++(int) { iterator old = *this; ++*this; return old; }
+        iterator& operator++()
+        {
+            do
+            {
+                it = target(it->next()[0].load(std::memory_order_acquire));
+            } while (marked(it->next()[0].load(std::memory_order_acquire)));
+            return *this;
+        }
+        bool operator==(const iterator& other) const { return it == other.it; }
+        bool operator!=(const iterator& other) const { return it != other.it; }
+        const std::pair<Key, T>& operator*() const { return it->pair; }
+        const std::pair<Key, T>* operator->() const { return &it->pair; }
+
+        // iterator traits
+        using difference_type = std::ptrdiff_t;
+        using value_type = std::pair<Key, T>;
+        using pointer = const std::pair<Key, T>*;
+        using reference = const std::pair<Key, T>&;
+        using iterator_category = std::forward_iterator_tag;
+    };
+
+    typedef int size_type;
+
+    ConcurrentSkipList(unsigned int maxLevels = 32);
+    ConcurrentSkipList(const ConcurrentSkipList&) = delete;
+    ConcurrentSkipList& operator=(const ConcurrentSkipList&) = delete;
+    ~ConcurrentSkipList(); // must not race with any other member call
+
+    iterator emplace(const Key& key, const T& value);
+    iterator insert(const std::pair<Key, T>& pair);
+    iterator find(const Key& key) const;
+    iterator lower_bound(const Key& key) const;
+    iterator upper_bound(const Key& key) const;
+    bool erase(const iterator& it);
+    size_type erase(const Key& key);
+
+    // delete-min: the popped elt is copied into @out, false if the list was empty
+    bool pop_front(std::pair<Key, T>& out); // exact, every caller races for the first live elt
+    bool pop_front_relaxed(std::pair<Key, T>& out, unsigned int spread = 0); // spray: claims a random elt among about the first 2 * @spread (0: the number of hardware threads)
+
+    iterator begin() const;
+    iterator end() const;
+    bool empty() const;
+
+private:
+    static constexpr int maxLevelsCap = 64;
+
+    static Node* target(std::uintptr_t link) { return reinterpret_cast<Node*>(link & ~std::uintptr_t(1)); }
+    static bool marked(std::uintptr_t link) { return (link & 1) != 0; }
+    static std::uintptr_t makeLink(Node* node, bool mark = false) { return reinterpret_cast<std::uintptr_t>(node) | (mark ? 1 : 0); }
+
+    static Node* createNode(int level);
+    static Node* createNode(const Key& key, const T& value, int level);
+    static void destroyNode(void* node);
+
+    int randomLevel() const;
+    bool goesBefore(Node* node, const Key& key, bool upper) const; // should the search move past @node ?
+    void search(const Key& key, bool upper, Node** preds, Node** succs) const; // also unlinks marked nodes on the way
+    Node* traverse(const Key& key, bool upper) const; // read-only search, skips marked nodes
+    bool eraseNode(Node* node);
+    void unlink(Node* node); // takes the (marked) @node out of every level it is still linked on
+    bool claimFrom(Node* node, std::pair<Key, T>& out); // erases the first live node from @node on (level 0)
+    void release(Node* node);
+
+    const int maxHeight; // max num of levels ("height")
+    mutable std::atomic<int> currentHeight{ 1 }; // current "height" of skip-list
+    Node* head; // head of skiplist
+    Node* tail; // tail of skiplist
+};
+
+/** implementation **/
+
+template<typename Key, typename T, class Compare>
+ConcurrentSkipList<Key, T, Compare>::ConcurrentSkipList(unsigned int maxHeight) : maxHeight(std::min<unsigned int>(std::max<unsigned int>(maxHeight, 1), maxLevelsCap)) // initialises a skiplist with the specified level height
+{
+    head = createNode(this->maxHeight - 1);
+    tail = createNode(this->maxHeight - 1);
+
+    for (int i = 0; i != this->maxHeight; i++)
+        head->next()[i].store(makeLink(tail), std::memory_order_relaxed);
+}
+
+template<typename Key, typename T, class Compare>
+ConcurrentSkipList<Key, T, Compare>::~ConcurrentSkipList()
+{
+    // everything still linked at level 0 is ours, erased nodes have already been retired
+    Node* it = head;
+    while (it != tail)
+    {
+        Node* next = target(it->next()[0].load(std::memory_order_relaxed));
+        destroyNode(it);
+        it = next;
+    }
+
+    destroyNode(tail);
+}
+
+template<typename Key, typename T, class Compare>
+typename ConcurrentSkipList<Key, T, Compare>::Node* ConcurrentSkipList<Key, T, Compare>::createNode(int level) // allocates a (sentinel) node with a default constructed pair
+{
+    void* block = ::operator new(Node::blockSize(level), std::align_val_t(64));
+    try
+    {
+        return new (block) Node(level);
+    }
+    catch (...)
+    {
+        ::operator delete(block, std::align_val_t(64));
+        throw;
+    }
+}
+
+template<typename Key, typename T, class Compare>
+typename ConcurrentSkipList<Key, T, Compare>::Node* ConcurrentSkipList<Key, T, Compare>::createNode(const Key& key, const T& value, int level) // allocates a node, its pair and its tower in one go
+{
+    void* block = ::operator new(Node::blockSize(level), std::align_val_t(64));
+    try
+    {
+        return new (block) Node(key, value, level);
+    }
+    catch (...)
+    {
+        ::operator delete(block, std::align_val_t(64));
+        throw;
+    }
+}
+
+template<typename Key, typename T, class Compare>
+void ConcurrentSkipList<Key, T, Compare>::destroyNode(void* node) // also used as the deleter for retired nodes
+{
+    static_cast<Node*>(node)->~Node();
+    ::operator delete(node, std::align_val_t(64));
+}
+
+template<typename Key, typename T, class Compare>
+int ConcurrentSkipList<Key, T, Compare>::randomLevel() const
+{
+    thread_local GeometricLevels<> levels((static_cast<std::uint64_t>(std::random_device{}()) << 32) | std::random_device{}());
+    int lvl = levels();
+
+    if (lvl >= maxHeight)
+        lvl = maxHeight - 1;
+    return lvl;
+}
+
+template<typename Key, typename T, class Compare>
+bool ConcurrentSkipList<Key, T, Compare>::goesBefore(Node* node, const Key& key, bool upper) const
+{
+    if (upper)
+        return !Compare()(node->pair.first, key); // node key <= key
+    return Compare()(key, node->pair.first); // node key < key
+}
+
+template<typename Key, typename T, class Compare>
+void ConcurrentSkipList<Key, T, Compare>::search(const Key& key, bool upper, Node** preds, Node** succs) const // fills in the predecessors/successors of the lower (or upper) bound of @key on every level
+{
+retry:
+    Node* pred = head;
+    for (int i = currentHeight.load(std::memory_order_acquire) - 1; i >= 0; i--)
+    {
+        Node* curr = target(pred->next()[i].load(std::memory_order_acquire));
+        while (curr != tail)
+        {
+            std::uintptr_t succ = curr->next()[i].load(std::memory_order_acquire);
+
+            // curr is being erased --> help unlinking it
+            if (marked(succ))
+            {
+                std::uintptr_t expected = makeLink(curr);
+                if (!pred->next()[i].compare_exchange_strong(expected, makeLink(target(succ)), std::memory_order_acq_rel, std::memory_order_acquire))
+                    goto retry; // pred changed under our feet
+                curr = target(succ);
+                continue;
+            }
+
+            if (!goesBefore(curr, key, upper))
+                break;
+
+            pred = curr;
+            curr = target(succ);
+        }
+
+        preds[i] = pred;
+        succs[i] = curr;
+    }
+}
+
+template<typename Key, typename T, class Compare>
+typename ConcurrentSkipList<Key, T, Compare>::Node* ConcurrentSkipList<Key, T, Compare>::traverse(const Key& key, bool upper) const // returns the first live node at level 0 that the search does not move past
+{
+    Node* pred = head;
+    Node* curr = tail;
+    for (int i = currentHeight.load(std::memory_order_acquire) - 1; i >= 0; i--)
+    {
+        curr = target(pred->next()[i].load(std::memory_order_acquire));
+        while (curr != tail)
+        {
+            std::uintptr_t succ = curr->next()[i].load(std::memory_order_acquire);
+            if (marked(succ)) // erased, step over it
+            {
+                curr = target(succ);
+                continue;
+            }
+
+            if (!goesBefore(curr, key, upper))
+                break;
+
+            pred = curr;
+            curr = target(succ);
+        }
+    }
+
+    return curr;
+}
+
+template<typename Key, typename T, class Compare>
+typename ConcurrentSkipList<Key, T, Compare>::iterator ConcurrentSkipList<Key, T, Compare>::emplace(const Key& key, const T& value) // inserts a new node (after all the nodes with an equal key)
+{
+    int lvl = randomLevel();
+    int height = currentHeight.load(std::memory_order_relaxed);
+    while (height < lvl + 1 && !currentHeight.compare_exchange_weak(height, lvl + 1, std::memory_order_acq_rel));
+
+    Node* preds[maxLevelsCap];
+    Node* succs[maxLevelsCap];
+    Node* newNode = createNode(key, value, lvl); // creation
+    EpochReclaimer::Guard guard;
+
+    // level 0 decides where the node is (and makes it visible)
+    while (true)
+    {
+        search(key, true, preds, succs);
+        for (int i = 0; i <= lvl; i++)
+            newNode->next()[i].store(makeLink(succs[i]), std::memory_order_relaxed);
+
+        std::uintptr_t expected = makeLink(succs[0]);
+        if (preds[0]->next()[0].compare_exchange_strong(expected, makeLink(newNode), std::memory_order_release, std::memory_order_relaxed))
+            break;
+    }
+
+    // build the tower, bottom to top
+    for (int i = 1; i <= lvl; i++)
+    {
+        while (true)
+        {
+            std::uintptr_t own = newNode->next()[i].load(std::memory_order_acquire);
+            if (marked(own))
+                goto built; // erased while we were building it, don't bother with the rest
+
+            // refresh our own link after a failed attempt
+            if (target(own) != succs[i] && !newNode->next()[i].compare_exchange_strong(own, makeLink(succs[i]), std::memory_order_acq_rel))
+                continue;
+
+            std::uintptr_t expected = makeLink(succs[i]);
+            if (preds[i]->next()[i].compare_exchange_strong(expected, makeLink(newNode), std::memory_order_release, std::memory_order_relaxed))
+                break;
+
+            search(key, true, preds, succs);
+        }
+    }
+
+built:
+    // an eraser might have missed the levels we linked after it marked them
+    if (marked(newNode->next()[0].load(std::memory_order_acquire)))
+        unlink(newNode);
+    release(newNode);
+
+    return iterator(newNode, std::move(guard));
+}
+
+template<typename Key, typename T, class Compare>
+typename ConcurrentSkipList<Key, T, Compare>::iterator ConcurrentSkipList<Key, T, Compare>::insert(const std::pair<Key, T>& pair) // alias for emplace(key, value)
+{
+    return emplace(pair.first, pair.second);
+}
+
+template<typename Key, typename T, class Compare>
+typename ConcurrentSkipList<Key, T, Compare>::iterator ConcurrentSkipList<Key, T, Compare>::find(const Key& key) const // returns an iterator to the first element with a key equivalent to @key, end() otherwise
+{
+    EpochReclaimer::Guard guard;
+    Node* node = traverse(key, false);
+    if (node != tail && !Compare()(node->pair.first, key)) // node key <= key, and it's also >= key
+        return iterator(node, std::move(guard));
+    return iterator(tail, std::move(guard));
+}
+
+template<typename Key, typename T, class Compare>
+typename ConcurrentSkipList<Key, T, Compare>::iterator ConcurrentSkipList<Key, T, Compare>::lower_bound(const Key& key) const // returns an iterator to the first element whose key does not go before @key
+{
+    EpochReclaimer::Guard guard;
+    Node* node = traverse(key, false);
+    return iterator(node, std::move(guard));
+}
+
+template<typename Key, typename T, class Compare>
+typename ConcurrentSkipList<Key, T, Compare>::iterator ConcurrentSkipList<Key, T, Compare>::upper_bound(const Key& key) const // returns an iterator to the first element whose key goes after @key
+{
+    EpochReclaimer::Guard guard;
+    Node* node = traverse(key, true);
+    return iterator(node, std::move(guard));
+}
+
+template<typename Key, typename T, class Compare>
+bool ConcurrentSkipList<Key, T, Compare>::eraseNode(Node* node) // returns whether this call was the one that erased @node
+{
+    // mark the upper levels, top to bottom
+    for (int i = node->height - 1; i >= 1; i--)
+    {
+        std::uintptr_t link = node->next()[i].load(std::memory_order_acquire);
+        while (!marked(link) && !node->next()[i].compare_exchange_weak(link, link | 1, std::memory_order_acq_rel));
+    }
+
+    // level 0 is the logical deletion, only one thread wins it
+    std::uintptr_t link = node->next()[0].load(std::memory_order_acquire);
+    while (true)
+    {
+        if (marked(link))
+            return false;
+        if (node->next()[0].compare_exchange_weak(link, link | 1, std::memory_order_acq_rel))
+            break;
+    }
+
+    // physical deletion, the node is retired once it is off every level
+    unlink(node);
+    release(node);
+
+    return true;
+}
+
+template<typename Key, typename T, class Compare>
+void ConcurrentSkipList<Key, T, Compare>::unlink(Node* node) // @node is marked on all its levels
+{
+    // a single search can't do it: with equal keys, the one that passes them lands behind @node on the upper levels
+    // and goes down from there. instead every level is walked from in front of the run of @node's key until @node is
+    // out (or the run ends: someone helped it out already), unlinking the marked nodes on the way
+    Node* preds[maxLevelsCap];
+    Node* succs[maxLevelsCap];
+retry:
+    search(node->pair.first, false, preds, succs);
+    for (int i = node->height - 1; i >= 0; i--)
+    {
+        Node* pred = preds[i];
+        Node* curr = succs[i];
+        while (curr != tail && !Compare()(curr->pair.first, node->pair.first))
+        {
+            std::uintptr_t succ = curr->next()[i].load(std::memory_order_acquire);
+            if (marked(succ))
+            {
+                std::uintptr_t expected = makeLink(curr);
+                if (!pred->next()[i].compare_exchange_strong(expected, makeLink(target(succ)), std::memory_order_acq_rel, std::memory_order_acquire))
+                    goto retry; // pred changed under our feet
+                if (curr == node)
+                    break; // off this level, it is linked only once
+                curr = target(succ);
+                continue;
+            }
+
+            pred = curr;
+            curr = target(succ);
+        }
+    }
+}
+
+template<typename Key, typename T, class Compare>
+void ConcurrentSkipList<Key, T, Compare>::release(Node* node) // the second one to let go of the node retires it
+{
+    if (node->pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        EpochReclaimer::retire(node, &ConcurrentSkipList::destroyNode);
+}
+
+template<typename Key, typename T, class Compare>
+bool ConcurrentSkipList<Key, T, Compare>::erase(const iterator& it) // erases the node @it points to, returns false if someone else erased it first
+{
+    if (it.it == head || it.it == tail || it.it == NULL)
+        return false;
+
+    EpochReclaimer::Guard guard;
+    return eraseNode(it.it);
+}
+
+template<typename Key, typename T, class Compare>
+typename ConcurrentSkipList<Key, T, Compare>::size_type ConcurrentSkipList<Key, T, Compare>::erase(const Key& key) // removes all the nodes with @key, returns the number of elts this call removed
+{
+    EpochReclaimer::Guard guard;
+    Node* preds[maxLevelsCap];
+    Node* succs[maxLevelsCap];
+    size_type count = 0;
+
+    while (true)
+    {
+        search(key, false, preds, succs);
+        Node* node = succs[0];
+        if (node == tail || Compare()(node->pair.first, key)) // no more nodes with @key
+            return count;
+
+        if (eraseNode(node))
+            count++;
+    }
+}
+
+template<typename Key, typename T, class Compare>
+bool ConcurrentSkipList<Key, T, Compare>::claimFrom(Node* node, std::pair<Key, T>& out) // the caller is pinned
+{
+    for (; node != tail; node = target(node->next()[0].load(std::memory_order_acquire)))
+    {
+        if (marked(node->next()[0].load(std::memory_order_acquire)))
+            continue; // someone else's already
+
+        if (eraseNode(node))
+        {
+            out = node->pair; // still readable, we are pinned
+            return true;
+        }
+    }
+
+    return false;
+}
+
+template<typename Key, typename T, class Compare>
+bool ConcurrentSkipList<Key, T, Compare>::pop_front(std::pair<Key, T>& out) // removes the first live elt
+{
+    EpochReclaimer::Guard guard;
+    return claimFrom(target(head->next()[0].load(std::memory_order_acquire)), out);
+}
+
+template<typename Key, typename T, class Compare>
+bool ConcurrentSkipList<Key, T, Compare>::pop_front_relaxed(std::pair<Key, T>& out, unsigned int spread) // removes one of the first elts, not necessarily the first one
+{
+    // with every thread popping the first elt they all fight over the same links; a spray walk (SprayList) spreads
+    // them over the first 2 * @spread elts instead: from a level about log2(spread) high, jump 0 or 1 live nodes
+    // to the right on every level on the way down
+    if (spread == 0)
+        spread = std::max(std::thread::hardware_concurrency(), 1u);
+
+    thread_local std::uint64_t state = (static_cast<std::uint64_t>(std::random_device{}()) << 32) | std::random_device{}() | 1;
+
+    int top = 0;
+    while (top + 1 < currentHeight.load(std::memory_order_acquire) && (2u << top) <= spread)
+        top++;
+
+    EpochReclaimer::Guard guard;
+    for (int attempt = 0; attempt != 2; attempt++)
+    {
+        // xorshift64, one bit per level
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        std::uint64_t jumps = state;
+
+        Node* it = head;
+        for (int i = top; i >= 0; i--, jumps >>= 1)
+        {
+            if ((jumps & 1) == 0)
+                continue;
+
+            Node* next = target(it->next()[i].load(std::memory_order_acquire));
+            while (next != tail && marked(next->next()[i].load(std::memory_order_acquire)))
+                next = target(next->next()[i].load(std::memory_order_acquire));
+            if (next != tail)
+                it = next;
+        }
+
+        if (it == head)
+            it = target(head->next()[0].load(std::memory_order_acquire));
+        if (claimFrom(it, out))
+            return true;
+    }
+
+    // the spray only found taken (or no) elts behind its landing point, the list may be short --> exact pop
+    return claimFrom(target(head->next()[0].load(std::memory_order_acquire)), out);
+}
+
+template<typename Key, typename T, class Compare>
+typename ConcurrentSkipList<Key, T, Compare>::iterator ConcurrentSkipList<Key, T, Compare>::begin() const // return start iterator of level 0
+{
+    EpochReclaimer::Guard guard;
+    iterator it(head, std::move(guard));
+    return ++it;
+}
+
+template<typename Key, typename T, class Compare>
+typename ConcurrentSkipList<Key, T, Compare>::iterator ConcurrentSkipList<Key, T, Compare>::end() const // return past-the-end iterator of level 0
+{
+    return iterator(tail, EpochReclaimer::Guard(nullptr));
+}
+
+template<typename Key, typename T, class Compare>
+bool ConcurrentSkipList<Key, T, Compare>::empty() const // returns whether there is no live element
+{
+    return begin() == end();
+}
+
+#endif // CONCURRENTSKIPLIST_H
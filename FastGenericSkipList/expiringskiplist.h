@@ -0,0 +1,313 @@
+#ifndef EXPIRINGSKIPLIST_H
+#define EXPIRINGSKIPLIST_H
+
+#include <functional> // greater
+#include <iterator> // forward_iterator_tag
+#include <utility> // pair, forward, piecewise_construct
+#include <tuple> // forward_as_tuple
+#include <cstdint> // uint64_t
+#include <chrono> // steady_clock
+
+#include "skiplist.h"
+
+
+/*
+ * skip list with a time to live per elt (session stores, caches), built on SkipList
+ * an elt inserted with a deadline gets a timer in a second list ordered by deadline, expire(now, budget) pops
+ * timers off its front and erases their elts, at most @budget per call, so reclaiming is spread over many short
+ * calls instead of one long pause. until then the expired elts stay linked: find, the bounds and the iterators
+ * step over them (comparing their deadline with the time of the lookup), they never reclaim anything themselves.
+ * find only looks at the elts with its key, O(log n + their number). lower_bound, upper_bound, begin and operator++
+ * walk the whole run of expired elts in front of the next live one, so they can cost O(expired run) until expire()
+ * catches up.
+ * not thread-safe, like SkipList.
+*/
+template <typename Key, typename T, class Compare = std::greater<Key>, class Clock = std::chrono::steady_clock> class ExpiringSkipList
+{
+public:
+    typedef typename Clock::time_point time_point;
+    typedef typename Clock::duration duration;
+    static constexpr time_point never = time_point::max(); // deadline of the elts without a ttl
+
+private:
+    struct Entry
+    {
+        Entry() : value(), deadline(never), timer(0) { } // head/tail of the list
+        template<class V>
+        Entry(V&& value, time_point deadline, std::uint64_t timer) : value(std::forward<V>(value)), deadline(deadline), timer(timer) { }
+
+        T value;
+        time_point deadline; // expired from then on
+        std::uint64_t timer; // tie breaker of the timer, (deadline, timer) is unique
+    };
+
+    typedef SkipList<Key, Entry, Compare> List;
+    typedef std::pair<time_point, std::uint64_t> Timer;
+    typedef SkipList<Timer, typename List::iterator, std::greater<Timer> > Timers; // earliest deadline first
+
+public:
+    typedef typename List::size_type size_type;
+
+    // iterator over the elts alive at the time it was made (forward only)
+    class iterator
+    {
+        friend class ExpiringSkipList;
+    private:
+        const ExpiringSkipList* list;
+        time_point now;
+        typename List::iterator it;
+
+        iterator(const ExpiringSkipList* list, time_point now, typename List::iterator it) : list(list), now(now), it(it) { }
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef std::pair<const Key&, T&> value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef value_type reference;
+
+        struct pointer // lets it->first / it->second work on the pair of references
+        {
+            value_type pair;
+            const value_type* operator->() const { return &pair; }
+        };
+
+        iterator() : list(NULL) { }
+        value_type operator*() const { return value_type(it->first, it->second.value); }
+        pointer operator->() const { return pointer{ **this }; }
+        iterator& operator++()
+        {
+            ++it;
+            list->skipExpired(it, now);
+            return *this;
+        }
+        iterator operator++(int) { iterator old = *this; ++*this; return old; }
+        bool operator==(const iterator& other) const { return it == other.it; }
+        bool operator!=(const iterator& other) const { return it != other.it; }
+        time_point deadline() const { return it->second.deadline; }
+    };
+
+    ExpiringSkipList(unsigned int maxLevels = 32);
+    ExpiringSkipList(const ExpiringSkipList&) = delete;
+    ExpiringSkipList& operator=(const ExpiringSkipList&) = delete;
+
+    template<class K, class V>
+    iterator emplace(K&& key, V&& value); // no ttl, lives until erased
+    template<class K, class V>
+    iterator emplace_for(K&& key, V&& value, duration ttl); // expires @ttl from now
+    template<class K, class V>
+    iterator emplace_until(K&& key, V&& value, time_point deadline);
+    iterator insert(const std::pair<Key, T>& pair);
+    iterator insert(const std::pair<Key, T>& pair, duration ttl);
+    void set_deadline(const iterator it, time_point deadline); // moves the deadline of an elt (never: no ttl any more), O(log n)
+
+    iterator find(const Key& key, time_point now = Clock::now()) const;
+    iterator lower_bound(const Key& key, time_point now = Clock::now()) const;
+    iterator upper_bound(const Key& key, time_point now = Clock::now()) const;
+    iterator erase(const iterator it);
+    size_type erase(const Key& key); // removes the elts with @key, expired ones included
+    size_type expire(time_point now = Clock::now(), size_type budget = 64); // reclaims up to @budget elts expired at @now, returns how many
+    time_point next_expiry() const; // earliest deadline of the elts still linked, never if none
+
+    iterator begin(time_point now = Clock::now()) const;
+    iterator end() const;
+    bool empty() const; // no elts linked (expired or not)
+    size_type size() const; // elts linked, the expired ones not reclaimed yet included
+    void clear();
+
+private:
+    void skipExpired(typename List::iterator& it, time_point now) const; // moves @it to the first elt alive at @now (or end)
+    iterator link(typename List::iterator it); // files the timer of a new elt
+    void unlinkTimer(typename List::iterator it); // drops the timer of an elt
+
+    List list;
+    Timers timers;
+    std::uint64_t timerCount = 0;
+};
+
+/** implementation **/
+
+template<typename Key, typename T, class Compare, class Clock>
+ExpiringSkipList<Key, T, Compare, Clock>::ExpiringSkipList(unsigned int maxLevels) : list(maxLevels), timers(maxLevels)
+{
+}
+
+template<typename Key, typename T, class Compare, class Clock>
+template<class K, class V>
+typename ExpiringSkipList<Key, T, Compare, Clock>::iterator ExpiringSkipList<Key, T, Compare, Clock>::emplace(K&& key, V&& value)
+{
+    return emplace_until(std::forward<K>(key), std::forward<V>(value), never);
+}
+
+template<typename Key, typename T, class Compare, class Clock>
+template<class K, class V>
+typename ExpiringSkipList<Key, T, Compare, Clock>::iterator ExpiringSkipList<Key, T, Compare, Clock>::emplace_for(K&& key, V&& value, duration ttl)
+{
+    return emplace_until(std::forward<K>(key), std::forward<V>(value), Clock::now() + ttl);
+}
+
+template<typename Key, typename T, class Compare, class Clock>
+template<class K, class V>
+typename ExpiringSkipList<Key, T, Compare, Clock>::iterator ExpiringSkipList<Key, T, Compare, Clock>::emplace_until(K&& key, V&& value, time_point deadline) // inserts behind the elts with an equivalent key
+{
+    typename List::iterator it = list.emplace(std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)), std::forward_as_tuple(std::forward<V>(value), deadline, ++timerCount));
+    return link(it);
+}
+
+template<typename Key, typename T, class Compare, class Clock>
+typename ExpiringSkipList<Key, T, Compare, Clock>::iterator ExpiringSkipList<Key, T, Compare, Clock>::insert(const std::pair<Key, T>& pair)
+{
+    return emplace(pair.first, pair.second);
+}
+
+template<typename Key, typename T, class Compare, class Clock>
+typename ExpiringSkipList<Key, T, Compare, Clock>::iterator ExpiringSkipList<Key, T, Compare, Clock>::insert(const std::pair<Key, T>& pair, duration ttl)
+{
+    return emplace_for(pair.first, pair.second, ttl);
+}
+
+template<typename Key, typename T, class Compare, class Clock>
+typename ExpiringSkipList<Key, T, Compare, Clock>::iterator ExpiringSkipList<Key, T, Compare, Clock>::link(typename List::iterator it)
+{
+    if (it->second.deadline != never)
+    {
+        try
+        {
+            timers.emplace(Timer(it->second.deadline, it->second.timer), it);
+        }
+        catch (...)
+        {
+            list.erase(it); // an elt without its timer would never expire
+            throw;
+        }
+    }
+
+    return iterator(this, Clock::now(), it);
+}
+
+template<typename Key, typename T, class Compare, class Clock>
+void ExpiringSkipList<Key, T, Compare, Clock>::unlinkTimer(typename List::iterator it)
+{
+    if (it->second.deadline != never)
+        timers.erase(timers.find(Timer(it->second.deadline, it->second.timer)));
+}
+
+template<typename Key, typename T, class Compare, class Clock>
+void ExpiringSkipList<Key, T, Compare, Clock>::set_deadline(const iterator it, time_point deadline)
+{
+    unlinkTimer(it.it);
+    it.it->second.deadline = deadline;
+    it.it->second.timer = ++timerCount;
+    if (deadline != never)
+        timers.emplace(Timer(deadline, it.it->second.timer), it.it);
+}
+
+template<typename Key, typename T, class Compare, class Clock>
+void ExpiringSkipList<Key, T, Compare, Clock>::skipExpired(typename List::iterator& it, time_point now) const
+{
+    for (; it != list.end() && it->second.deadline <= now; ++it);
+}
+
+template<typename Key, typename T, class Compare, class Clock>
+typename ExpiringSkipList<Key, T, Compare, Clock>::iterator ExpiringSkipList<Key, T, Compare, Clock>::find(const Key& key, time_point now) const // first elt alive at @now with a key equivalent to @key, end() if none
+{
+    // only the run of equal keys, the expired elts behind it can be any number
+    for (typename List::iterator it = list.lower_bound(key); it != list.end() && !Compare()(it->first, key); ++it)
+        if (it->second.deadline > now)
+            return iterator(this, now, it);
+
+    return end();
+}
+
+template<typename Key, typename T, class Compare, class Clock>
+typename ExpiringSkipList<Key, T, Compare, Clock>::iterator ExpiringSkipList<Key, T, Compare, Clock>::lower_bound(const Key& key, time_point now) const // first elt alive at @now whose key does not go before @key
+{
+    typename List::iterator it = list.lower_bound(key);
+    skipExpired(it, now);
+    return iterator(this, now, it);
+}
+
+template<typename Key, typename T, class Compare, class Clock>
+typename ExpiringSkipList<Key, T, Compare, Clock>::iterator ExpiringSkipList<Key, T, Compare, Clock>::upper_bound(const Key& key, time_point now) const // first elt alive at @now whose key goes after @key
+{
+    typename List::iterator it = list.upper_bound(key);
+    skipExpired(it, now);
+    return iterator(this, now, it);
+}
+
+template<typename Key, typename T, class Compare, class Clock>
+typename ExpiringSkipList<Key, T, Compare, Clock>::iterator ExpiringSkipList<Key, T, Compare, Clock>::erase(const iterator it) // removes the elt, returns the next one alive at the time of @it
+{
+    unlinkTimer(it.it);
+    typename List::iterator next = list.erase(it.it);
+    skipExpired(next, it.now);
+    return iterator(this, it.now, next);
+}
+
+template<typename Key, typename T, class Compare, class Clock>
+typename ExpiringSkipList<Key, T, Compare, Clock>::size_type ExpiringSkipList<Key, T, Compare, Clock>::erase(const Key& key)
+{
+    size_type count = 0;
+    typename List::iterator it = list.lower_bound(key);
+    while (it != list.end() && !Compare()(it->first, key))
+    {
+        unlinkTimer(it);
+        it = list.erase(it);
+        count++;
+    }
+
+    return count;
+}
+
+template<typename Key, typename T, class Compare, class Clock>
+typename ExpiringSkipList<Key, T, Compare, Clock>::size_type ExpiringSkipList<Key, T, Compare, Clock>::expire(time_point now, size_type budget) // O(budget) work at most (each pop/erase is O(height)), call it again while it returns @budget
+{
+    size_type count = 0;
+    while (count != budget && !timers.empty() && timers.front().first.first <= now)
+    {
+        list.erase(timers.front().second);
+        timers.pop_front();
+        count++;
+    }
+
+    return count;
+}
+
+template<typename Key, typename T, class Compare, class Clock>
+typename ExpiringSkipList<Key, T, Compare, Clock>::time_point ExpiringSkipList<Key, T, Compare, Clock>::next_expiry() const
+{
+    return timers.empty() ? never : timers.front().first.first;
+}
+
+template<typename Key, typename T, class Compare, class Clock>
+typename ExpiringSkipList<Key, T, Compare, Clock>::iterator ExpiringSkipList<Key, T, Compare, Clock>::begin(time_point now) const // first elt alive at @now
+{
+    typename List::iterator it = list.begin();
+    skipExpired(it, now);
+    return iterator(this, now, it);
+}
+
+template<typename Key, typename T, class Compare, class Clock>
+typename ExpiringSkipList<Key, T, Compare, Clock>::iterator ExpiringSkipList<Key, T, Compare, Clock>::end() const
+{
+    return iterator(this, time_point::min(), list.end());
+}
+
+template<typename Key, typename T, class Compare, class Clock>
+bool ExpiringSkipList<Key, T, Compare, Clock>::empty() const
+{
+    return list.empty();
+}
+
+template<typename Key, typename T, class Compare, class Clock>
+typename ExpiringSkipList<Key, T, Compare, Clock>::size_type ExpiringSkipList<Key, T, Compare, Clock>::size() const
+{
+    return list.size();
+}
+
+template<typename Key, typename T, class Compare, class Clock>
+void ExpiringSkipList<Key, T, Compare, Clock>::clear()
+{
+    timers.clear();
+    list.clear();
+}
+
+#endif // EXPIRINGSKIPLIST_H
@@ -0,0 +1,209 @@
+#ifndef FROZENSKIPLIST_H
+#define FROZENSKIPLIST_H
+
+#include <functional> // greater
+#include <utility> // pair
+#include <cstdint> // uint32_t, uint64_t, uintptr_t
+#include <cstddef> // size_t
+#include <cstring> // memcmp, memcpy
+#include <string> // string
+#include <stdexcept> // runtime_error
+#include <algorithm> // partition_point
+#include <limits> // numeric_limits
+#include <type_traits> // is_trivially_copyable
+
+
+/*
+ * image of a SkipList, written by SkipList::save() and read back by SkipList::load() or, in place, by FrozenSkipList:
+ * [ SkipListImageHeader | heights[0 .. count-1] (one byte per elt, only with the towerHeights flag) | records[0 .. count-1] ]
+ * records are the std::pair<Key, T> of the elts in level 0 order, with their in-memory layout (native byte order and
+ * padding, checked when the image is read), starting at recordsOffset, a multiple of 64.
+*/
+struct SkipListImageHeader
+{
+    static constexpr std::uint32_t currentVersion = 1;
+    static constexpr std::uint32_t byteOrderMark = 0x01020304;
+    enum Flags { towerHeights = 1 };
+
+    char magic[4]; // "FGSL"
+    std::uint32_t version;
+    std::uint32_t byteOrder; // byteOrderMark, as the writer stored it
+    std::uint32_t flags;
+    std::uint32_t keySize;
+    std::uint32_t valueSize;
+    std::uint32_t recordSize; // sizeof(std::pair<Key, T>)
+    std::uint32_t recordAlign; // alignof(std::pair<Key, T>)
+    std::uint64_t count; // number of elts
+    std::uint64_t recordsOffset; // from the start of the image
+    unsigned char reserved[16];
+
+    template<typename Key, typename T>
+    static SkipListImageHeader make(std::uint64_t count, bool heights); // header of an image of @count <Key, T> elts
+    template<typename Key, typename T>
+    const char* mismatch() const; // why an image with this header can't hold <Key, T> elts, NULL if it can
+};
+
+static_assert(sizeof(SkipListImageHeader) == 64, "the image header takes one cache line");
+
+/*
+ * read-only view of a SkipList image (a mapped file or any other buffer), nothing is copied or deserialised.
+ * level 0 is an array in the image, so the links are implicit (the next elt is the next record) and a search is a
+ * binary search over the records: O(log n), like the list it was saved from.
+ * the image must outlive the view, be aligned for std::pair<Key, T> (mmap gives page alignment) and have been
+ * saved by a SkipList with the same Compare.
+*/
+template <typename Key, typename T, class Compare = std::greater<Key> > class FrozenSkipList
+{
+public:
+    typedef std::pair<Key, T> value_type;
+    typedef const value_type* iterator; // records are contiguous, iterators are plain pointers (random access)
+    typedef int size_type;
+
+    static_assert(std::is_trivially_copyable<Key>::value && std::is_trivially_copyable<T>::value, "images hold trivially copyable keys and values only");
+
+    FrozenSkipList(const void* image, std::size_t bytes); // throws std::runtime_error if @image is not a valid image of <Key, T> elts
+
+    iterator find(const Key& key) const;
+    iterator lower_bound(const Key& key) const;
+    iterator upper_bound(const Key& key) const;
+    std::pair<iterator, iterator> equal_range(const Key& key) const;
+    size_type count(const Key& key) const;
+    iterator at_rank(size_type rank) const;
+
+    iterator begin() const;
+    iterator end() const;
+    bool empty() const;
+    size_type size() const;
+
+private:
+    const value_type* records;
+    size_type length;
+};
+
+/** implementation **/
+
+template<typename Key, typename T>
+SkipListImageHeader SkipListImageHeader::make(std::uint64_t count, bool heights)
+{
+    SkipListImageHeader header = SkipListImageHeader();
+    std::memcpy(header.magic, "FGSL", 4);
+    header.version = currentVersion;
+    header.byteOrder = byteOrderMark;
+    header.flags = heights ? towerHeights : 0;
+    header.keySize = sizeof(Key);
+    header.valueSize = sizeof(T);
+    header.recordSize = sizeof(std::pair<Key, T>);
+    header.recordAlign = alignof(std::pair<Key, T>);
+    header.count = count;
+    header.recordsOffset = sizeof(SkipListImageHeader) + (heights ? (count + 63) / 64 * 64 : 0);
+    return header;
+}
+
+template<typename Key, typename T>
+const char* SkipListImageHeader::mismatch() const
+{
+    if (std::memcmp(magic, "FGSL", 4) != 0)
+        return "not a skip list image";
+    if (version != currentVersion)
+        return "unsupported image version";
+    if (byteOrder != byteOrderMark)
+        return "image written with another byte order";
+    if (keySize != sizeof(Key) || valueSize != sizeof(T) || recordSize != sizeof(std::pair<Key, T>) || recordAlign != alignof(std::pair<Key, T>))
+        return "image written for other key/value types";
+    if (count > static_cast<std::uint64_t>(std::numeric_limits<int>::max()))
+        return "image too large";
+    // the heights (if any) and their padding sit between the header and the records, nothing else (save() writes no more)
+    std::uint64_t heightBytes = (flags & towerHeights) ? count : 0;
+    if (recordsOffset < sizeof(SkipListImageHeader) + heightBytes || recordsOffset > sizeof(SkipListImageHeader) + (heightBytes + 63) / 64 * 64 || recordsOffset % 64 != 0)
+        return "corrupt image header";
+    return NULL;
+}
+
+template<typename Key, typename T, class Compare>
+FrozenSkipList<Key, T, Compare>::FrozenSkipList(const void* image, std::size_t bytes)
+{
+    if (bytes < sizeof(SkipListImageHeader))
+        throw std::runtime_error("FrozenSkipList: image too small");
+
+    SkipListImageHeader header;
+    std::memcpy(&header, image, sizeof(header));
+    const char* problem = header.mismatch<Key, T>();
+    if (problem != NULL)
+        throw std::runtime_error(std::string("FrozenSkipList: ") + problem);
+    if (header.recordsOffset > bytes || header.count > (bytes - header.recordsOffset) / sizeof(value_type)) // no sum that could wrap
+        throw std::runtime_error("FrozenSkipList: image truncated");
+
+    const unsigned char* base = static_cast<const unsigned char*>(image) + header.recordsOffset;
+    if (reinterpret_cast<std::uintptr_t>(base) % alignof(value_type) != 0)
+        throw std::runtime_error("FrozenSkipList: image not aligned for its records");
+
+    records = reinterpret_cast<const value_type*>(base);
+    length = static_cast<size_type>(header.count);
+}
+
+template<typename Key, typename T, class Compare>
+typename FrozenSkipList<Key, T, Compare>::iterator FrozenSkipList<Key, T, Compare>::find(const Key& key) const // first elt with a key equivalent to @key, end() if none
+{
+    iterator it = lower_bound(key);
+    if (it == end() || Compare()(it->first, key))
+        return end();
+    return it;
+}
+
+template<typename Key, typename T, class Compare>
+typename FrozenSkipList<Key, T, Compare>::iterator FrozenSkipList<Key, T, Compare>::lower_bound(const Key& key) const // first elt whose key does not go before @key
+{
+    return std::partition_point(begin(), end(), [&](const value_type& elt) { return Compare()(key, elt.first); });
+}
+
+template<typename Key, typename T, class Compare>
+typename FrozenSkipList<Key, T, Compare>::iterator FrozenSkipList<Key, T, Compare>::upper_bound(const Key& key) const // first elt whose key goes after @key
+{
+    return std::partition_point(begin(), end(), [&](const value_type& elt) { return !Compare()(elt.first, key); });
+}
+
+template<typename Key, typename T, class Compare>
+std::pair<typename FrozenSkipList<Key, T, Compare>::iterator, typename FrozenSkipList<Key, T, Compare>::iterator> FrozenSkipList<Key, T, Compare>::equal_range(const Key& key) const
+{
+    return std::make_pair(lower_bound(key), upper_bound(key));
+}
+
+template<typename Key, typename T, class Compare>
+typename FrozenSkipList<Key, T, Compare>::size_type FrozenSkipList<Key, T, Compare>::count(const Key& key) const
+{
+    return static_cast<size_type>(upper_bound(key) - lower_bound(key));
+}
+
+template<typename Key, typename T, class Compare>
+typename FrozenSkipList<Key, T, Compare>::iterator FrozenSkipList<Key, T, Compare>::at_rank(size_type rank) const // elt at 0-based position @rank, end() if there is no such elt (like SkipList::at_rank)
+{
+    if (rank < 0 || rank >= length)
+        return end();
+    return records + rank;
+}
+
+template<typename Key, typename T, class Compare>
+typename FrozenSkipList<Key, T, Compare>::iterator FrozenSkipList<Key, T, Compare>::begin() const
+{
+    return records;
+}
+
+template<typename Key, typename T, class Compare>
+typename FrozenSkipList<Key, T, Compare>::iterator FrozenSkipList<Key, T, Compare>::end() const
+{
+    return records + length;
+}
+
+template<typename Key, typename T, class Compare>
+bool FrozenSkipList<Key, T, Compare>::empty() const
+{
+    return length == 0;
+}
+
+template<typename Key, typename T, class Compare>
+typename FrozenSkipList<Key, T, Compare>::size_type FrozenSkipList<Key, T, Compare>::size() const
+{
+    return length;
+}
+
+#endif // FROZENSKIPLIST_H
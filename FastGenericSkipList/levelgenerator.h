@@ -0,0 +1,84 @@
+#ifndef LEVELGENERATOR_H
+#define LEVELGENERATOR_H
+
+#include <cstdint> // uint64_t
+
+#if defined(_MSC_VER)
+#include <intrin.h> // _BitScanReverse64
+#endif
+
+
+/*
+ * level generators roll the height of new nodes. a generator (the Levels parameter of SkipList/UnrolledSkipList) needs:
+ * - a default constructor and seed(std::uint64_t), the same seed gives the same sequence of levels
+ * - int operator()(), returning a level >= 0, level l with probability (1 - p) * p^l (the list caps it)
+ * - static constexpr int log2Inverse, log2(1/p): the list caps the levels at about log_{1/p}(size), see levelCap()
+*/
+
+inline int levelLeadingZeros(std::uint64_t x) // number of leading zero bits, x must not be 0
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse64(&index, x);
+    return 63 - static_cast<int>(index);
+#else
+    return __builtin_clzll(x);
+#endif
+}
+
+inline int levelBitWidth(std::uint64_t x) // bits needed for x, 0 for 0
+{
+    return x != 0 ? 64 - levelLeadingZeros(x) : 0;
+}
+
+// highest level worth having in a list of @elts (nodes, or blocks) at p = 1 / 2^Levels::log2Inverse: levels far above
+// log_{1/p}(n) only cost time, so the cap grows with the list (up to maxHeight - 1)
+template<class Levels>
+inline int levelCap(std::uint64_t elts, int maxHeight)
+{
+    int cap = levelBitWidth(elts + 1) / Levels::log2Inverse + 1;
+    return cap < maxHeight - 1 ? cap : maxHeight - 1;
+}
+
+template<class Levels>
+inline int cappedLevel(Levels& levels, std::uint64_t elts, int maxHeight) // rolls the level of a new node for a list of @elts, capped by levelCap()
+{
+    int lvl = levels();
+    int cap = levelCap<Levels>(elts, maxHeight);
+    return lvl < cap ? lvl : cap;
+}
+
+/*
+ * geometric levels with p = 1 / 2^Log2Inverse (1: p = 1/2, 2: p = 1/4), from a single xorshift64* draw:
+ * every level takes Log2Inverse more leading zero bits (the high bits of xorshift64* are the good ones)
+*/
+template <int Log2Inverse = 1> class GeometricLevels
+{
+    static_assert(Log2Inverse >= 1 && Log2Inverse <= 8, "p must be between 1/2 and 1/256");
+
+public:
+    static constexpr int log2Inverse = Log2Inverse;
+
+    GeometricLevels(std::uint64_t seed = defaultSeed) { this->seed(seed); }
+
+    void seed(std::uint64_t value)
+    {
+        state = value != 0 ? value : defaultSeed; // xorshift is stuck at 0
+    }
+
+    int operator()()
+    {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        std::uint64_t bits = state * 0x2545F4914F6CDD1DULL;
+        return levelLeadingZeros(bits | 1) / Log2Inverse; // the low bit keeps clz defined
+    }
+
+private:
+    static constexpr std::uint64_t defaultSeed = 0x9E3779B97F4A7C15ULL;
+
+    std::uint64_t state;
+};
+
+#endif // LEVELGENERATOR_H
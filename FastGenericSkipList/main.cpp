@@ -1,8 +1,19 @@
 #include <iostream>
-#include <random> // uniform_real_distribution, default_random_engine
+#include <random> // uniform_real_distribution, default_random_engine, discrete_distribution
 #include <map>
 #include <chrono>
+#include <thread>
+#include <mutex>
+#include <vector>
+#include <string>
+#include <algorithm> // shuffle
+#include <numeric> // accumulate
 #include "skiplist.h"
+#include "concurrentskiplist.h"
+#include "unrolledskiplist.h"
+#include "augmentedskiplist.h"
+#include "stringskiplist.h"
+#include "adaptiveskiplist.h"
 #define TEST_SIZE 1000000
 
 using namespace std;
@@ -15,6 +26,16 @@ class TestClass
     char d;
 };
 
+template<class Work>
+void runThreads(unsigned int threadCount, Work work) // runs work(threadIndex) on @threadCount threads, waits for all of them
+{
+    vector<thread> threads;
+    for (unsigned int t = 0; t != threadCount; t++)
+        threads.emplace_back(work, t);
+    for (thread& t : threads)
+        t.join();
+}
+
 int main(int argc, char *argv[])
 {
     // random distributions, generator
@@ -137,6 +158,27 @@ int main(int argc, char *argv[])
 
 
 
+    cout << "BATCH SEARCH TESTS [START]..." << endl;
+    /* BATCH SEARCH TEST: INT SKIPLIST */
+    start = std::chrono::steady_clock::now();
+    intSkiplist.find_batch(intPool, intPool + TEST_SIZE, intSkiplistIterators);
+    end = std::chrono::steady_clock::now();
+    cout << "BATCH SEARCH TEST: INT SKIPLIST - " << chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms" << endl;
+
+    /* BATCH SEARCH TEST: DOUBLE SKIPLIST */
+    start = std::chrono::steady_clock::now();
+    doubleSkiplist.find_batch(doublePool, doublePool + TEST_SIZE, doubleSkiplistIterators);
+    end = std::chrono::steady_clock::now();
+    cout << "BATCH SEARCH TEST: DOUBLE SKIPLIST - " << chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms" << endl;
+
+    cout << "BATCH SEARCH TESTS [END]..." << endl;
+
+
+
+    cout << endl;
+
+
+
     cout << "ERASE TESTS [START]..." << endl;
     /* ERASE TEST: INT SKIPLIST */
     start = std::chrono::steady_clock::now();
@@ -363,6 +405,14 @@ int main(int argc, char *argv[])
     end = std::chrono::steady_clock::now();
     cout << "SWEEP TEST: INT SKIPLIST - " << chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms" << endl;
 
+    /* PARALLEL SWEEP TEST: INT SKIPLIST */
+    start = std::chrono::steady_clock::now();
+
+    intSkiplist.parallel_for_each(-TEST_SIZE, TEST_SIZE + 1, [](pair<int, TestClass>&) { });
+
+    end = std::chrono::steady_clock::now();
+    cout << "PARALLEL SWEEP TEST: INT SKIPLIST - " << chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms" << endl;
+
     /* SWEEP TEST: INT MULTIMAP */
     start = std::chrono::steady_clock::now();
 
@@ -395,5 +445,454 @@ int main(int argc, char *argv[])
 
     cout << "SWEEP TESTS [END]..." << endl;
 
+
+
+    cout << endl;
+
+
+
+    cout << "SORTED BULK BUILD TESTS [START]..." << endl;
+    vector<pair<int, TestClass> > sortedIntPairs;
+    for (multimap<int, TestClass>::iterator it = intMmap.begin(); it != intMmap.end(); it++)
+        sortedIntPairs.push_back(*it);
+
+    /* SORTED BULK BUILD TEST: INT SKIPLIST */
+    start = std::chrono::steady_clock::now();
+    {
+        SkipList<int, TestClass> bulkSkiplist(sortedIntPairs.begin(), sortedIntPairs.end());
+        end = std::chrono::steady_clock::now();
+    }
+    cout << "SORTED BULK BUILD TEST: INT SKIPLIST - " << chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms" << endl;
+
+    /* SORTED BULK BUILD TEST: INT MULTIMAP */
+    start = std::chrono::steady_clock::now();
+    {
+        multimap<int, TestClass> bulkMmap(sortedIntPairs.begin(), sortedIntPairs.end());
+        end = std::chrono::steady_clock::now();
+    }
+    cout << "SORTED BULK BUILD TEST: INT MULTIMAP - " << chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms" << endl;
+
+    vector<pair<int, TestClass> > shuffledIntPairs(sortedIntPairs);
+    shuffle(shuffledIntPairs.begin(), shuffledIntPairs.end(), generator);
+
+    /* UNSORTED BULK BUILD TEST: INT SKIPLIST (parallel_build) */
+    start = std::chrono::steady_clock::now();
+    {
+        SkipList<int, TestClass> bulkSkiplist;
+        bulkSkiplist.parallel_build(shuffledIntPairs.begin(), shuffledIntPairs.end());
+        end = std::chrono::steady_clock::now();
+    }
+    cout << "UNSORTED BULK BUILD TEST: INT SKIPLIST (parallel_build) - " << chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms" << endl;
+
+    /* UNSORTED BULK BUILD TEST: INT MULTIMAP */
+    start = std::chrono::steady_clock::now();
+    {
+        multimap<int, TestClass> bulkMmap(shuffledIntPairs.begin(), shuffledIntPairs.end());
+        end = std::chrono::steady_clock::now();
+    }
+    cout << "UNSORTED BULK BUILD TEST: INT MULTIMAP - " << chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms" << endl;
+
+    cout << "SORTED BULK BUILD TESTS [END]..." << endl;
+
+
+
+    cout << endl;
+
+
+
+    cout << "RANGE ERASE TESTS [START]..." << endl;
+    const int windowWidth = 2 * TEST_SIZE / 100; // expire the key space in 100 windows
+
+    /* RANGE ERASE TEST: INT SKIPLIST (erase_range) */
+    {
+        SkipList<int, TestClass> rangeSkiplist(sortedIntPairs.begin(), sortedIntPairs.end());
+        start = std::chrono::steady_clock::now();
+        for (int lo = -TEST_SIZE; lo < TEST_SIZE; lo += windowWidth)
+            rangeSkiplist.erase_range(lo, lo + windowWidth);
+        end = std::chrono::steady_clock::now();
+    }
+    cout << "RANGE ERASE TEST: INT SKIPLIST (erase_range) - " << chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms" << endl;
+
+    /* RANGE ERASE TEST: INT SKIPLIST (one by one) */
+    {
+        SkipList<int, TestClass> rangeSkiplist(sortedIntPairs.begin(), sortedIntPairs.end());
+        start = std::chrono::steady_clock::now();
+        for (int lo = -TEST_SIZE; lo < TEST_SIZE; lo += windowWidth)
+        {
+            SkipList<int, TestClass>::iterator it = rangeSkiplist.lower_bound(lo);
+            SkipList<int, TestClass>::iterator last = rangeSkiplist.lower_bound(lo + windowWidth);
+            while (it != last)
+                it = rangeSkiplist.erase(it);
+        }
+        end = std::chrono::steady_clock::now();
+    }
+    cout << "RANGE ERASE TEST: INT SKIPLIST (one by one) - " << chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms" << endl;
+
+    /* RANGE ERASE TEST: INT MULTIMAP */
+    {
+        multimap<int, TestClass> rangeMmap(sortedIntPairs.begin(), sortedIntPairs.end());
+        start = std::chrono::steady_clock::now();
+        for (int lo = -TEST_SIZE; lo < TEST_SIZE; lo += windowWidth)
+            rangeMmap.erase(rangeMmap.lower_bound(lo), rangeMmap.lower_bound(lo + windowWidth));
+        end = std::chrono::steady_clock::now();
+    }
+    cout << "RANGE ERASE TEST: INT MULTIMAP - " << chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms" << endl;
+
+    cout << "RANGE ERASE TESTS [END]..." << endl;
+
+
+
+    cout << endl;
+
+
+
+    cout << "RANGE AGGREGATE TESTS [START]..." << endl;
+    vector<pair<int, int> > intValuePairs;
+    for (int i = 0; i != TEST_SIZE; i++)
+        intValuePairs.emplace_back(intPool[i], i % 1000);
+    const int aggregateWidth = TEST_SIZE / 20; // a 40th of the key range per window
+
+    /* RANGE AGGREGATE TEST: INT AUGMENTED SKIPLIST (aggregate) */
+    {
+        AugmentedSkipList<int, int, SumOf<int> > sumSkiplist;
+        for (const pair<int, int>& pair : intValuePairs)
+            sumSkiplist.insert(pair);
+
+        long long total = 0;
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i != TEST_SIZE / 1000; i++)
+            total += sumSkiplist.aggregate(intPool[i], intPool[i] + aggregateWidth);
+        end = std::chrono::steady_clock::now();
+        cout << "RANGE AGGREGATE TEST: INT AUGMENTED SKIPLIST (aggregate) - " << chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms (" << total << ")" << endl;
+    }
+
+    /* RANGE AGGREGATE TEST: INT MULTIMAP (scan) */
+    {
+        multimap<int, int> sumMmap(intValuePairs.begin(), intValuePairs.end());
+
+        long long total = 0;
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i != TEST_SIZE / 1000; i++)
+        {
+            multimap<int, int>::iterator last = sumMmap.lower_bound(intPool[i] + aggregateWidth);
+            for (multimap<int, int>::iterator it = sumMmap.lower_bound(intPool[i]); it != last; it++)
+                total += it->second;
+        }
+        end = std::chrono::steady_clock::now();
+        cout << "RANGE AGGREGATE TEST: INT MULTIMAP (scan) - " << chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms (" << total << ")" << endl;
+    }
+
+    cout << "RANGE AGGREGATE TESTS [END]..." << endl;
+
+
+
+    cout << endl;
+
+
+
+    cout << "STRING KEY TESTS [START]..." << endl;
+    vector<string> pathPool; // long keys sharing most of their bytes
+    for (int i = 0; i != TEST_SIZE / 4; i++)
+        pathPool.push_back("/srv/data/warehouse/tables/events/partition=" + to_string(intPool[i] % 64) + "/part-" + to_string(intPool[i]));
+    int hits;
+
+    /* STRING KEY FIND TEST: SKIPLIST<STRING> */
+    {
+        SkipList<string, int> stringSkiplist;
+        for (const string& path : pathPool)
+            stringSkiplist.insert(path, 0);
+
+        hits = 0;
+        start = std::chrono::steady_clock::now();
+        for (const string& path : pathPool)
+            hits += stringSkiplist.find(path) != stringSkiplist.end();
+        end = std::chrono::steady_clock::now();
+    }
+    cout << "STRING KEY FIND TEST: SKIPLIST<STRING> - " << chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms (" << hits << " hits)" << endl;
+
+    /* STRING KEY FIND TEST: STRING SKIPLIST */
+    {
+        StringSkipList<int> stringSkiplist;
+        for (const string& path : pathPool)
+            stringSkiplist.emplace(path, 0);
+
+        hits = 0;
+        start = std::chrono::steady_clock::now();
+        for (const string& path : pathPool)
+            hits += stringSkiplist.find(path) != stringSkiplist.end();
+        end = std::chrono::steady_clock::now();
+    }
+    cout << "STRING KEY FIND TEST: STRING SKIPLIST - " << chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms (" << hits << " hits)" << endl;
+
+    /* STRING KEY FIND TEST: MULTIMAP<STRING> */
+    {
+        multimap<string, int> stringMmap;
+        for (const string& path : pathPool)
+            stringMmap.emplace(path, 0);
+
+        hits = 0;
+        start = std::chrono::steady_clock::now();
+        for (const string& path : pathPool)
+            hits += stringMmap.find(path) != stringMmap.end();
+        end = std::chrono::steady_clock::now();
+    }
+    cout << "STRING KEY FIND TEST: MULTIMAP<STRING> - " << chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms (" << hits << " hits)" << endl;
+
+    cout << "STRING KEY TESTS [END]..." << endl;
+
+
+
+    cout << endl;
+
+
+
+    cout << "ZIPFIAN SEARCH TESTS [START]..." << endl;
+    vector<double> zipfWeights(TEST_SIZE); // rank r is looked up with probability ~ 1 / (r + 1)
+    for (int i = 0; i != TEST_SIZE; i++)
+        zipfWeights[i] = 1.0 / (i + 1);
+    discrete_distribution<int> zipfDistribution(zipfWeights.begin(), zipfWeights.end());
+    vector<int> zipfKeys(TEST_SIZE); // the hot keys are spread all over the list
+    for (int i = 0; i != TEST_SIZE; i++)
+        zipfKeys[i] = intPool[zipfDistribution(generator)];
+
+    /* ZIPFIAN SEARCH TEST: INT SKIPLIST */
+    {
+        SkipList<int, TestClass> zipfSkiplist;
+        for (int i = 0; i != TEST_SIZE; i++)
+            zipfSkiplist.emplace(intPool[i], TestClass());
+
+        hits = 0;
+        start = std::chrono::steady_clock::now();
+        for (int key : zipfKeys)
+            hits += zipfSkiplist.find(key) != zipfSkiplist.end();
+        end = std::chrono::steady_clock::now();
+    }
+    cout << "ZIPFIAN SEARCH TEST: INT SKIPLIST - " << chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms (" << hits << " hits)" << endl;
+
+    /* ZIPFIAN SEARCH TEST: INT ADAPTIVE SKIPLIST */
+    int promotedLevels;
+    {
+        AdaptiveSkipList<int, TestClass> zipfSkiplist;
+        for (int i = 0; i != TEST_SIZE; i++)
+            zipfSkiplist.emplace(intPool[i], TestClass());
+
+        hits = 0;
+        start = std::chrono::steady_clock::now();
+        for (int key : zipfKeys)
+            hits += zipfSkiplist.find(key) != zipfSkiplist.end();
+        end = std::chrono::steady_clock::now();
+        promotedLevels = zipfSkiplist.promoted_levels();
+    }
+    cout << "ZIPFIAN SEARCH TEST: INT ADAPTIVE SKIPLIST - " << chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms (" << hits << " hits, " << promotedLevels << " promoted levels)" << endl;
+
+    /* ZIPFIAN SEARCH TEST: INT MULTIMAP */
+    {
+        multimap<int, TestClass> zipfMmap;
+        for (int i = 0; i != TEST_SIZE; i++)
+            zipfMmap.emplace(intPool[i], TestClass());
+
+        hits = 0;
+        start = std::chrono::steady_clock::now();
+        for (int key : zipfKeys)
+            hits += zipfMmap.find(key) != zipfMmap.end();
+        end = std::chrono::steady_clock::now();
+    }
+    cout << "ZIPFIAN SEARCH TEST: INT MULTIMAP - " << chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms (" << hits << " hits)" << endl;
+    cout << "ZIPFIAN SEARCH TESTS [END]..." << endl;
+
+
+
+    cout << endl;
+
+
+
+    cout << "SPLIT/JOIN TESTS [START]..." << endl;
+    /* SPLIT/JOIN TEST: INT SKIPLIST */
+    {
+        SkipList<int, TestClass> shardedSkiplist(sortedIntPairs.begin(), sortedIntPairs.end());
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i != 1000; i++)
+        {
+            SkipList<int, TestClass> upperShard = shardedSkiplist.split_at(intPool[i]);
+            shardedSkiplist.join(upperShard);
+        }
+        end = std::chrono::steady_clock::now();
+    }
+    cout << "SPLIT/JOIN TEST (1000x): INT SKIPLIST - " << chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms" << endl;
+
+    /* MERGE TEST: INT SKIPLIST */
+    {
+        SkipList<int, TestClass> evenSkiplist, oddSkiplist;
+        for (size_t i = 0; i != sortedIntPairs.size(); i++)
+            (i % 2 == 0 ? evenSkiplist : oddSkiplist).insert(sortedIntPairs[i]);
+        start = std::chrono::steady_clock::now();
+        evenSkiplist.merge(oddSkiplist);
+        end = std::chrono::steady_clock::now();
+    }
+    cout << "MERGE TEST: INT SKIPLIST - " << chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms" << endl;
+
+    /* MERGE TEST: INT MULTIMAP */
+    {
+        multimap<int, TestClass> evenMmap, oddMmap;
+        for (size_t i = 0; i != sortedIntPairs.size(); i++)
+            (i % 2 == 0 ? evenMmap : oddMmap).insert(sortedIntPairs[i]);
+        start = std::chrono::steady_clock::now();
+        evenMmap.merge(oddMmap);
+        end = std::chrono::steady_clock::now();
+    }
+    cout << "MERGE TEST: INT MULTIMAP - " << chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms" << endl;
+
+    cout << "SPLIT/JOIN TESTS [END]..." << endl;
+
+
+
+    cout << endl;
+
+
+
+    cout << "UNROLLED SKIPLIST TESTS [START]..." << endl;
+    UnrolledSkipList<int, TestClass> intUnrolled;
+
+    /* INSERTION TEST: INT UNROLLED SKIPLIST */
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i != TEST_SIZE; i++)
+    {
+        intUnrolled.emplace(intPool[i], TestClass());
+    }
+    end = std::chrono::steady_clock::now();
+    cout << "INSERTION TEST: INT UNROLLED SKIPLIST - " << chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms" << endl;
+
+    /* SEARCH TEST: INT UNROLLED SKIPLIST */
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i != TEST_SIZE; i++)
+    {
+        intUnrolled.find(intPool[i]);
+    }
+    end = std::chrono::steady_clock::now();
+    cout << "SEARCH TEST: INT UNROLLED SKIPLIST - " << chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms" << endl;
+
+    /* LOWER_BOUND TEST: INT UNROLLED SKIPLIST */
+    start = std::chrono::steady_clock::now();
+    for (int i = -TEST_SIZE; i < TEST_SIZE; i += step)
+    {
+        intUnrolled.lower_bound(i);
+    }
+    end = std::chrono::steady_clock::now();
+    cout << "LOWER_BOUND TEST: INT UNROLLED SKIPLIST - " << chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms" << endl;
+
+    /* SWEEP TEST: INT UNROLLED SKIPLIST */
+    start = std::chrono::steady_clock::now();
+
+    UnrolledSkipList<int, TestClass>::iterator intItUnrolled = intUnrolled.begin();
+    while(intItUnrolled != intUnrolled.end())
+        intItUnrolled++;
+
+    end = std::chrono::steady_clock::now();
+    cout << "SWEEP TEST: INT UNROLLED SKIPLIST - " << chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms" << endl;
+
+    /* ERASE TEST: INT UNROLLED SKIPLIST */
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i != TEST_SIZE; i++)
+    {
+        intUnrolled.erase(intPool[i]);
+    }
+    end = std::chrono::steady_clock::now();
+    cout << "ERASE TEST: INT UNROLLED SKIPLIST - " << chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms" << endl;
+
+    cout << "UNROLLED SKIPLIST TESTS [END]..." << endl;
+
+
+
+    cout << endl;
+
+
+
+    cout << "CONCURRENT SCALING TESTS [START]..." << endl;
+    const unsigned int maxThreads = max(thread::hardware_concurrency(), 1u);
+    for (unsigned int threadCount = 1; threadCount <= maxThreads; threadCount *= 2)
+    {
+        ConcurrentSkipList<int, TestClass> concurrentSkiplist;
+        SkipList<int, TestClass> lockedSkiplist;
+        mutex lockedSkiplistMutex;
+        const int share = TEST_SIZE / threadCount;
+
+        /* CONCURRENT INSERTION TEST: INT CONCURRENT SKIPLIST */
+        start = std::chrono::steady_clock::now();
+        runThreads(threadCount, [&](unsigned int t)
+        {
+            for (int i = t * share; i != (int)(t + 1) * share; i++)
+                concurrentSkiplist.emplace(intPool[i], TestClass());
+        });
+        end = std::chrono::steady_clock::now();
+        cout << "CONCURRENT INSERTION TEST (" << threadCount << " threads): INT CONCURRENT SKIPLIST - " << chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms" << endl;
+
+        /* CONCURRENT INSERTION TEST: INT SKIPLIST + MUTEX */
+        start = std::chrono::steady_clock::now();
+        runThreads(threadCount, [&](unsigned int t)
+        {
+            for (int i = t * share; i != (int)(t + 1) * share; i++)
+            {
+                lock_guard<mutex> lock(lockedSkiplistMutex);
+                lockedSkiplist.emplace(intPool[i], TestClass());
+            }
+        });
+        end = std::chrono::steady_clock::now();
+        cout << "CONCURRENT INSERTION TEST (" << threadCount << " threads): INT SKIPLIST + MUTEX - " << chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms" << endl;
+
+        /* CONCURRENT SEARCH TEST: INT CONCURRENT SKIPLIST */
+        vector<long> searchHits(threadCount, 0); // per thread, the results are used so the searches can't be optimised away
+        start = std::chrono::steady_clock::now();
+        runThreads(threadCount, [&](unsigned int t)
+        {
+            long found = 0;
+            for (int i = t * share; i != (int)(t + 1) * share; i++)
+                found += concurrentSkiplist.find(intPool[i]) != concurrentSkiplist.end();
+            searchHits[t] = found;
+        });
+        end = std::chrono::steady_clock::now();
+        cout << "CONCURRENT SEARCH TEST (" << threadCount << " threads): INT CONCURRENT SKIPLIST - " << chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms (" << accumulate(searchHits.begin(), searchHits.end(), 0L) << " hits)" << endl;
+
+        /* CONCURRENT SEARCH TEST: INT SKIPLIST + MUTEX */
+        start = std::chrono::steady_clock::now();
+        runThreads(threadCount, [&](unsigned int t)
+        {
+            long found = 0;
+            for (int i = t * share; i != (int)(t + 1) * share; i++)
+            {
+                lock_guard<mutex> lock(lockedSkiplistMutex);
+                found += lockedSkiplist.find(intPool[i]) != lockedSkiplist.end();
+            }
+            searchHits[t] = found;
+        });
+        end = std::chrono::steady_clock::now();
+        cout << "CONCURRENT SEARCH TEST (" << threadCount << " threads): INT SKIPLIST + MUTEX - " << chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms (" << accumulate(searchHits.begin(), searchHits.end(), 0L) << " hits)" << endl;
+
+        /* CONCURRENT ERASE TEST: INT CONCURRENT SKIPLIST */
+        start = std::chrono::steady_clock::now();
+        runThreads(threadCount, [&](unsigned int t)
+        {
+            for (int i = t * share; i != (int)(t + 1) * share; i++)
+                concurrentSkiplist.erase(intPool[i]);
+        });
+        end = std::chrono::steady_clock::now();
+        cout << "CONCURRENT ERASE TEST (" << threadCount << " threads): INT CONCURRENT SKIPLIST - " << chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms" << endl;
+
+        /* CONCURRENT ERASE TEST: INT SKIPLIST + MUTEX */
+        start = std::chrono::steady_clock::now();
+        runThreads(threadCount, [&](unsigned int t)
+        {
+            for (int i = t * share; i != (int)(t + 1) * share; i++)
+            {
+                lock_guard<mutex> lock(lockedSkiplistMutex);
+                lockedSkiplist.erase(intPool[i]);
+            }
+        });
+        end = std::chrono::steady_clock::now();
+        cout << "CONCURRENT ERASE TEST (" << threadCount << " threads): INT SKIPLIST + MUTEX - " << chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms" << endl;
+
+        cout << endl;
+    }
+    cout << "CONCURRENT SCALING TESTS [END]..." << endl;
+
     return 0;
 }
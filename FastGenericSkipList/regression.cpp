@@ -0,0 +1,781 @@
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <sstream>
+#include <stdexcept>
+#include <map>
+#include <random>
+#include <limits>
+#include <list>
+#include <chrono>
+#include "skiplist.h"
+#include "concurrentskiplist.h"
+#include "unrolledskiplist.h"
+#include "versionedskiplist.h"
+#include "expiringskiplist.h"
+
+/*
+ * regression tests, meant to run under AddressSanitizer (Regression.pro builds with it):
+ * a use-after-free or double free shows up as an ASan report, wrong contents as a FAILED line
+ * the compile-time modes change the code under test, build it once per mode (see Regression.pro)
+*/
+
+using namespace std;
+
+static int failures = 0;
+
+static bool frozenRejects(const vector<unsigned char>& image) // does FrozenSkipList refuse the image ?
+{
+    try
+    {
+        FrozenSkipList<int, int> frozen(image.data(), image.size());
+    }
+    catch (const std::runtime_error&)
+    {
+        return true;
+    }
+    return false;
+}
+
+#define CHECK(condition) \
+    do { if (!(condition)) { cout << "FAILED: " << #condition << " (" << __FILE__ << ":" << __LINE__ << ")" << endl; failures++; } } while (0)
+
+template<class Work>
+void runThreads(unsigned int threadCount, Work work) // runs work(threadIndex) on @threadCount threads, waits for all of them
+{
+    vector<thread> threads;
+    for (unsigned int t = 0; t != threadCount; t++)
+        threads.emplace_back(work, t);
+    for (thread& t : threads)
+        t.join();
+}
+
+template<class Compare> struct GoesBefore // std::multimap order of a skip list Compare (Compare()(a, b): a goes after b)
+{
+    template<typename Key>
+    bool operator()(const Key& a, const Key& b) const { return Compare()(b, a); }
+};
+
+template<class Iterator, class MapIterator>
+bool sameElt(Iterator it, Iterator end, MapIterator ref, MapIterator refEnd) // same position, the values tell equal keys apart
+{
+    if (it == end || ref == refEnd)
+        return (it == end) == (ref == refEnd);
+    return it->first == ref->first && it->second == ref->second;
+}
+
+template<class List, class Map>
+bool sameContents(const List& list, const Map& reference) // same elts in the same order
+{
+    if ((size_t)list.size() != reference.size())
+        return false;
+    typename Map::const_iterator ref = reference.begin();
+    for (typename List::iterator it = list.begin(); it != list.end(); ++it, ++ref)
+        if (it->first != ref->first || it->second != ref->second)
+            return false;
+    return true;
+}
+
+template<typename Key>
+Key testKey(mt19937& random, int range) // a narrow range (long runs of equal keys), the extremes now and then
+{
+    int k = uniform_int_distribution<int>(-range, range)(random);
+    if (k == range)
+        return numeric_limits<Key>::max();
+    if (k == -range)
+        return numeric_limits<Key>::lowest();
+    return static_cast<Key>(k) / static_cast<Key>(2);
+}
+
+template<typename Key>
+void checkKernels() // vector compares against the scalar loop, every length around the vector widths
+{
+    mt19937 random(11);
+    const SimdKeyOp ops[] = { simdLess, simdLessEqual, simdGreater, simdGreaterEqual };
+    for (int round = 0; round != 200; round++)
+    {
+        Key keys[20];
+        const int count = round % 20;
+        for (int l = 0; l != count; l++)
+            keys[l] = testKey<Key>(random, 8);
+        const Key key = testKey<Key>(random, 9);
+        for (SimdKeyOp op : ops)
+        {
+            int found = 0;
+            int highest = -1;
+            for (int l = 0; l != count; l++)
+            {
+                bool hit = op == simdLess ? keys[l] < key : op == simdLessEqual ? keys[l] <= key : op == simdGreater ? keys[l] > key : keys[l] >= key;
+                found += hit;
+                if (hit)
+                    highest = l;
+            }
+            CHECK(simdCount(keys, count, key, op) == found);
+            CHECK(simdHighest(keys, count, key, op) == highest);
+        }
+    }
+}
+
+template<class List, typename Key, class Compare>
+void checkKeySearch() // lower_bound/upper_bound/find/erase of @List against std::multimap, over runs of equal keys
+{
+    mt19937 random(7);
+    List list;
+    multimap<Key, int, GoesBefore<Compare> > reference;
+    for (int i = 0; i != 3000; i++)
+    {
+        const Key key = testKey<Key>(random, 200);
+        list.emplace(key, i);
+        reference.emplace(key, i);
+    }
+
+    for (int i = 0; i != 3000; i++)
+    {
+        const Key key = testKey<Key>(random, 210); // a few keys past both ends
+        CHECK(sameElt(list.lower_bound(key), list.end(), reference.lower_bound(key), reference.end()));
+        CHECK(sameElt(list.upper_bound(key), list.end(), reference.upper_bound(key), reference.end()));
+        CHECK(sameElt(list.find(key), list.end(), reference.count(key) != 0 ? reference.lower_bound(key) : reference.end(), reference.end()));
+        if (i % 4 == 0)
+            CHECK(list.erase(key) == (int)reference.erase(key));
+        else if (i % 4 == 1 && list.lower_bound(key) != list.end())
+        {
+            list.erase(list.lower_bound(key));
+            reference.erase(reference.lower_bound(key));
+        }
+    }
+    CHECK(sameContents(list, reference));
+}
+
+template<typename Key>
+void checkKeyType()
+{
+    checkKernels<Key>();
+    checkKeySearch<SkipList<Key, int, greater<Key> >, Key, greater<Key> >();
+    checkKeySearch<SkipList<Key, int, less<Key> >, Key, less<Key> >();
+    checkKeySearch<UnrolledSkipList<Key, int, greater<Key> >, Key, greater<Key> >();
+    checkKeySearch<UnrolledSkipList<Key, int, less<Key> >, Key, less<Key> >();
+}
+
+template<class List, class Map>
+bool sameIndex(const List& list, const Map& reference) // same contents, both ways, and every rank_of/at_rank right (they read the link widths)
+{
+    if (!sameContents(list, reference))
+        return false;
+    typename Map::const_reverse_iterator ref = reference.rbegin();
+    typename List::iterator it = list.end();
+    for (; it != list.begin(); ++ref)
+    {
+        --it;
+        if (it->first != ref->first || it->second != ref->second)
+            return false;
+    }
+    int rank = 0;
+    for (it = list.begin(); it != list.end(); ++it, ++rank)
+        if (list.rank_of(it) != rank || list.at_rank(rank) != it)
+            return false;
+    return list.rank_of(list.end()) == list.size() && list.at_rank(list.size()) == list.end();
+}
+
+template<class List, class Map>
+void fillRuns(List& list, Map& reference, int keys, int first) // keys [0, @keys) three times each, the values count up from @first
+{
+    for (int i = 0; i != 3 * keys; i++)
+    {
+        list.emplace(i % keys, first + i);
+        reference.emplace(i % keys, first + i);
+    }
+}
+
+template<class List, class Map>
+bool sameSnapshot(const typename List::view& view, const Map& copy) // the view shows the copy taken with it, scans and searches
+{
+    typename Map::const_iterator ref = copy.begin();
+    for (typename List::iterator it = view.begin(); it != view.end(); ++it, ++ref)
+        if (ref == copy.end() || it->first != ref->first || it->second != ref->second)
+            return false;
+    if (ref != copy.end())
+        return false;
+
+    for (int key = -1; key <= 201; key += 3)
+    {
+        if (!sameElt(view.lower_bound(key), view.end(), copy.lower_bound(key), copy.end())
+            || !sameElt(view.upper_bound(key), view.end(), copy.upper_bound(key), copy.end())
+            || !sameElt(view.find(key), view.end(), copy.count(key) != 0 ? copy.lower_bound(key) : copy.end(), copy.end())
+            || view.count(key) != (int)copy.count(key))
+            return false;
+    }
+    return true;
+}
+
+struct ManualClock // time only moves when the test says so
+{
+    typedef chrono::milliseconds duration;
+    typedef duration::rep rep;
+    typedef duration::period period;
+    typedef chrono::time_point<ManualClock> time_point;
+    static constexpr bool is_steady = true;
+
+    static time_point now() { return current; }
+    static time_point current;
+};
+ManualClock::time_point ManualClock::current;
+
+int main()
+{
+    cout << "MODES:"
+#if defined(SKIPLIST_SIMD_TOWERS)
+         << " simd_towers"
+#endif
+#if defined(SKIPLIST_SINGLE_LINKED_TOWERS)
+         << " single_linked"
+#endif
+#if defined(SKIPLIST_NO_SIMD)
+         << " no_simd"
+#endif
+         << (SimdLanes<int>::count != 0 ? " vector_kernels" : " scalar_kernels") << endl;
+
+    const int copies = 2000;
+
+    cout << "CONCURRENT SKIPLIST DUPLICATE KEYS [START]..." << endl;
+    /* ERASE(BEGIN) OVER EQUAL KEYS: a taller equal node behind the erased one used to keep it linked */
+    {
+        ConcurrentSkipList<int, int> list;
+        for (int i = 0; i != copies; i++)
+            list.emplace(7, i);
+
+        int erased = 0;
+        while (!list.empty())
+        {
+            CHECK(list.begin()->second == erased);
+            erased += list.erase(list.begin());
+        }
+        CHECK(erased == copies);
+    }
+
+    /* ERASE(KEY) OVER EQUAL KEYS, between other keys */
+    {
+        ConcurrentSkipList<int, int> list;
+        for (int i = 0; i != copies; i++)
+        {
+            list.emplace(i % 3, i);
+            list.emplace(7, i);
+        }
+
+        CHECK(list.erase(7) == copies);
+        CHECK(list.find(7) == list.end());
+        int left = 0;
+        for (ConcurrentSkipList<int, int>::iterator it = list.begin(); it != list.end(); ++it)
+            left++;
+        CHECK(left == copies);
+    }
+
+    /* CONCURRENT INSERTION AND ERASE OF EQUAL KEYS */
+    {
+        ConcurrentSkipList<int, int> list;
+        const unsigned int threadCount = 4;
+        vector<int> erased(threadCount, 0);
+        runThreads(threadCount, [&](unsigned int t)
+        {
+            for (int i = 0; i != copies; i++)
+            {
+                list.emplace(7, i);
+                if (i % 2 == 1)
+                    erased[t] += list.erase(list.begin());
+            }
+        });
+
+        int total = 0;
+        for (int count : erased)
+            total += count;
+        int left = 0;
+        for (ConcurrentSkipList<int, int>::iterator it = list.begin(); it != list.end(); ++it)
+            left++;
+        CHECK(total + left == (int)threadCount * copies);
+    }
+
+    /* POP_FRONT OVER EQUAL KEYS: every delete-min goes through the same unlink */
+    {
+        ConcurrentSkipList<int, int> list;
+        for (int i = 0; i != copies; i++)
+            list.emplace(7, i);
+
+        pair<int, int> out;
+        int popped = 0;
+        while (list.pop_front(out))
+        {
+            CHECK(out.first == 7 && out.second == popped);
+            popped++;
+        }
+        CHECK(popped == copies);
+        CHECK(list.empty());
+    }
+
+    /* POP_FRONT_RELAXED OVER EQUAL KEYS, a few distinct priorities */
+    {
+        ConcurrentSkipList<int, int> list;
+        for (int i = 0; i != copies; i++)
+            list.emplace(i % 4, i);
+
+        pair<int, int> out;
+        int popped = 0;
+        while (list.pop_front_relaxed(out, 8))
+            popped++;
+        CHECK(popped == copies);
+        CHECK(list.empty());
+    }
+
+    /* CONCURRENT PUSH AND POP OF EQUAL KEYS */
+    {
+        ConcurrentSkipList<int, int> list;
+        const unsigned int threadCount = 4;
+        vector<int> popped(threadCount, 0);
+        runThreads(threadCount, [&](unsigned int t)
+        {
+            pair<int, int> out;
+            for (int i = 0; i != copies; i++)
+            {
+                list.emplace(7, i);
+                if (i % 2 == 1)
+                    popped[t] += t % 2 == 0 ? list.pop_front(out) : list.pop_front_relaxed(out);
+            }
+        });
+
+        int total = 0;
+        for (int count : popped)
+            total += count;
+        pair<int, int> out;
+        while (list.pop_front(out))
+            total++;
+        CHECK(total == (int)threadCount * copies);
+    }
+    cout << "CONCURRENT SKIPLIST DUPLICATE KEYS [END]..." << endl;
+
+    cout << "VERSIONED SKIPLIST SNAPSHOTS [START]..." << endl;
+    /* SNAPSHOTS AGAINST COPIES: every view keeps showing the list as it was, however the writes go on */
+    {
+        typedef VersionedSkipList<int, int> List;
+        typedef multimap<int, int> Map;
+        List list;
+        Map current;
+        std::list<pair<List::view, Map> > snapshots; // views with a copy of the list taken at the same time
+        mt19937 random(13);
+        for (int i = 0; i != 6000; i++)
+        {
+            int key = uniform_int_distribution<int>(0, 200)(random);
+            if (i % 3 == 2)
+            {
+                CHECK(list.erase(key) == (int)current.erase(key));
+            }
+            else
+            {
+                list.emplace(key, i);
+                current.emplace(key, i);
+            }
+            CHECK(list.size() == (int)current.size());
+
+            if (i % 150 == 0)
+                snapshots.emplace_back(list.snapshot(), current);
+            if (i % 400 == 399 && !snapshots.empty()) // release one from the middle, the older ones still hold their versions
+            {
+                std::list<pair<List::view, Map> >::iterator it = snapshots.begin();
+                advance(it, uniform_int_distribution<int>(0, snapshots.size() - 1)(random));
+                snapshots.erase(it);
+            }
+            if (i % 500 == 0)
+                for (const pair<List::view, Map>& snapshot : snapshots)
+                    CHECK(sameSnapshot<List>(snapshot.first, snapshot.second));
+        }
+
+        for (const pair<List::view, Map>& snapshot : snapshots)
+            CHECK(sameSnapshot<List>(snapshot.first, snapshot.second));
+        CHECK(list.versions() > list.size()); // erased versions kept for the views
+        snapshots.clear();
+        CHECK(list.versions() == list.size()); // and reclaimed with the last of them
+        List::view now = list.snapshot();
+        CHECK(sameSnapshot<List>(now, current));
+    }
+
+    /* TWO WRITERS, THREE SCANNING READERS: a view scans the same versions every time, reclamation waits for it */
+    {
+        typedef VersionedSkipList<int, int> List;
+        List list;
+        const int writes = 20000;
+        runThreads(5, [&](unsigned int t)
+        {
+            mt19937 random(t);
+            if (t < 2) // writers, each on keys of its own, the value is always the key
+            {
+                for (int i = 0; i != writes; i++)
+                {
+                    int key = 2 * uniform_int_distribution<int>(0, 500)(random) + t;
+                    if (i % 2 == 0)
+                        list.emplace(key, key);
+                    else
+                        list.erase(key);
+                }
+                return;
+            }
+
+            for (int round = 0; round != 60; round++)
+            {
+                List::view view = list.snapshot();
+                vector<pair<int, int> > first;
+                for (List::iterator it = view.begin(); it != view.end(); ++it)
+                    first.emplace_back(it->first, it->second);
+                CHECK(is_sorted(first.begin(), first.end()));
+                for (const pair<int, int>& elt : first)
+                    if (elt.first != elt.second)
+                        CHECK(elt.first == elt.second);
+
+                vector<pair<int, int> > second;
+                for (List::iterator it = view.begin(); it != view.end(); ++it)
+                    second.emplace_back(it->first, it->second);
+                CHECK(first == second);
+                if (!first.empty())
+                    CHECK(view.find(first.back().first) != view.end());
+            }
+        });
+        CHECK(list.versions() == list.size()); // no view left, every erased version reclaimed
+    }
+    /* FIND AND COUNT IN AN OLD VIEW: the versions born after it are hidden, only the ones with the key are looked at */
+    {
+        typedef VersionedSkipList<int, int> List;
+        List list;
+        list.emplace(-1, -1);
+        List::view old = list.snapshot();
+        for (int i = 0; i != 200000; i++)
+            list.emplace(2 * i, i); // hidden from the view
+
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        int found = 0;
+        for (int i = 0; i != 2000; i++)
+            found += (old.find(2 * i * 97) != old.end()) + old.count(2 * i * 97 + 1);
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        CHECK(found == 0);
+        CHECK(ms < 200); // seconds when every miss walked the hidden versions behind it
+        CHECK(old.find(-1) != old.end() && old.count(-1) == 1);
+        CHECK(list.snapshot().count(0) == 1);
+    }
+    cout << "VERSIONED SKIPLIST SNAPSHOTS [END]..." << endl;
+
+    cout << "EXPIRING SKIPLIST BACKLOG [START]..." << endl;
+    /* FIND OVER A BACKLOG OF EXPIRED ELTS: only the run of equal keys is looked at, not everything expired behind it */
+    {
+        typedef ExpiringSkipList<int, int, greater<int>, ManualClock> List;
+        List list;
+        const int expired = 200000;
+        for (int i = 0; i != expired; i++)
+            list.emplace_for(2 * i, i, chrono::milliseconds(10)); // even keys, all expired below
+        list.emplace(2 * expired, -1); // no ttl, the first live elt behind the backlog
+        list.emplace_for(8, 1000, chrono::milliseconds(100)); // behind the expired 8, still alive below
+        ManualClock::current += chrono::milliseconds(50);
+        CHECK(list.expire(ManualClock::now(), 256) == 256);
+
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        int found = 0;
+        for (int i = 0; i != 2000; i++)
+            found += list.find(2 * (300 + i * 97) + 1) != list.end(); // odd keys are missing
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        CHECK(found == 0);
+        CHECK(ms < 200); // about 2000 * 10 ms with the whole backlog walked for every miss
+        CHECK(list.find(1000) == list.end()); // expired, not reclaimed
+        CHECK(list.find(8) != list.end() && list.find(8)->second == 1000); // the live one behind the expired one
+        CHECK(list.find(2 * expired) != list.end() && list.find(2 * expired)->second == -1);
+        CHECK(list.lower_bound(1000) != list.end() && list.lower_bound(1000)->first == 2 * expired); // the bounds still walk the backlog
+        CHECK(list.begin()->first == 8);
+
+        while (list.expire(ManualClock::now(), 256) == 256);
+        CHECK(list.size() == 2);
+        ManualClock::current += chrono::milliseconds(100);
+        CHECK(list.find(8) == list.end());
+        CHECK(list.expire(ManualClock::now()) == 1 && list.size() == 1);
+    }
+    cout << "EXPIRING SKIPLIST BACKLOG [END]..." << endl;
+
+    cout << "IMAGE HEADERS [START]..." << endl;
+    /* FORGED HEADERS: sizes that used to wrap around the bounds checks */
+    {
+        SkipList<int, int> list;
+        for (int i = 0; i != 100; i++)
+            list.emplace(i, i);
+        std::ostringstream out;
+        list.save(out, true);
+        const string saved = out.str();
+        const vector<unsigned char> good(saved.begin(), saved.end()); // vector storage is aligned for the records
+        CHECK(!frozenRejects(good));
+        FrozenSkipList<int, int> frozen(good.data(), good.size());
+        CHECK(frozen.at_rank(99)->first == 99);
+        CHECK(frozen.at_rank(100) == frozen.end() && frozen.at_rank(-1) == frozen.end()); // same as SkipList::at_rank
+        CHECK(list.at_rank(100) == list.end());
+
+        vector<unsigned char> image = good;
+        SkipListImageHeader header;
+        std::memcpy(&header, image.data(), sizeof(header));
+        header.recordsOffset = 0xfffffffffffffd00ULL; // offset + 100 records wraps around to 32
+        std::memcpy(image.data(), &header, sizeof(header));
+        CHECK(frozenRejects(image));
+
+        std::memcpy(&header, good.data(), sizeof(header));
+        header.count = 1000000; // more records than the image holds
+        header.flags = 0;
+        header.recordsOffset = sizeof(header);
+        std::memcpy(image.data(), &header, sizeof(header));
+        CHECK(frozenRejects(image));
+
+        // SkipList::load on the same kind of headers: a clean error, no huge allocation or negative skip
+        std::memcpy(&header, good.data(), sizeof(header));
+        header.count = 0x7fffffff; // heights for 2^31 elts announced, a few bytes there
+        header.recordsOffset = sizeof(header) + (header.count + 63) / 64 * 64;
+        string forged = saved;
+        std::memcpy(&forged[0], &header, sizeof(header));
+        std::istringstream in(forged);
+        bool rejected = false;
+        try
+        {
+            list.load(in);
+        }
+        catch (const std::runtime_error&)
+        {
+            rejected = true;
+        }
+        CHECK(rejected && list.empty());
+
+        std::memcpy(&header, good.data(), sizeof(header));
+        header.recordsOffset = 0xffffffffffff63c0ULL;
+        std::memcpy(&forged[0], &header, sizeof(header));
+        std::istringstream in2(forged);
+        rejected = false;
+        try
+        {
+            list.load(in2);
+        }
+        catch (const std::runtime_error&)
+        {
+            rejected = true;
+        }
+        CHECK(rejected && list.empty());
+
+        std::istringstream in3(saved);
+        list.load(in3);
+        CHECK(list.size() == 100);
+    }
+    cout << "IMAGE HEADERS [END]..." << endl;
+
+    cout << "RANGE ERASE [START]..." << endl;
+    /* ERASE(FIRST, LAST), ERASE_RANGE AND EXTRACT_RANGE: the ends of the cut and the widths bridging it */
+    {
+        typedef SkipList<int, int> List;
+        typedef multimap<int, int> Map;
+        List list;
+        Map reference;
+        fillRuns(list, reference, 1000, 0);
+
+        CHECK(list.erase_range(500, 500) == 0); // empty
+        CHECK(list.erase_range(600, 400) == 0); // lo > hi
+        CHECK(list.erase(list.begin(), list.begin()) == list.begin());
+        CHECK(list.erase(list.end(), list.end()) == list.end());
+        CHECK(sameIndex(list, reference));
+
+        CHECK(list.erase(list.begin(), list.lower_bound(50)) == list.lower_bound(50)); // at begin()
+        reference.erase(reference.begin(), reference.lower_bound(50));
+        CHECK(sameIndex(list, reference));
+
+        CHECK(list.erase(list.lower_bound(950), list.end()) == list.end()); // up to end()
+        reference.erase(reference.lower_bound(950), reference.end());
+        CHECK(sameIndex(list, reference));
+
+        CHECK(list.erase_range(-10, 60) == 30); // past the front
+        reference.erase(reference.begin(), reference.lower_bound(60));
+        CHECK(list.erase_range(940, 2000) == 30); // past the back
+        reference.erase(reference.lower_bound(940), reference.end());
+        CHECK(sameIndex(list, reference));
+
+        mt19937 random(3);
+        for (int round = 0; round != 100; round++)
+        {
+            int lo = uniform_int_distribution<int>(0, 1000)(random);
+            int hi = lo + uniform_int_distribution<int>(-5, 20)(random);
+            size_t expected = lo < hi ? distance(reference.lower_bound(lo), reference.lower_bound(hi)) : 0;
+            CHECK(list.erase_range(lo, hi) == (int)expected);
+            if (lo < hi)
+                reference.erase(reference.lower_bound(lo), reference.lower_bound(hi));
+
+            int first = uniform_int_distribution<int>(0, list.size())(random);
+            int last = min(list.size(), first + uniform_int_distribution<int>(0, 10)(random));
+            list.erase(list.at_rank(first), list.at_rank(last));
+            reference.erase(next(reference.begin(), first), next(reference.begin(), last));
+        }
+        CHECK(sameIndex(list, reference));
+
+        CHECK(list.erase(list.begin(), list.end()) == list.end()); // the whole list
+        reference.clear();
+        CHECK(list.empty() && sameIndex(list, reference));
+        fillRuns(list, reference, 100, 0);
+        CHECK(list.erase_range(0, 100) == 300);
+        reference.clear();
+        CHECK(list.empty() && sameIndex(list, reference));
+        CHECK(list.erase_range(0, 100) == 0);
+        CHECK(list.extract_range(0, 100).empty());
+    }
+
+    /* EXTRACT_RANGE, THEN BOTH LISTS GROW AND SHRINK: the extracted nodes stay in the chunks of the first list */
+    {
+        typedef SkipList<int, int> List;
+        typedef multimap<int, int> Map;
+        Map reference;
+        Map extractedReference;
+        List* list = new List();
+        fillRuns(*list, reference, 1000, 0);
+
+        List extracted = list->extract_range(200, 400);
+        extractedReference.insert(reference.lower_bound(200), reference.lower_bound(400));
+        reference.erase(reference.lower_bound(200), reference.lower_bound(400));
+        CHECK(sameIndex(*list, reference));
+        CHECK(sameIndex(extracted, extractedReference));
+
+        for (int i = 0; i != 600; i++) // into the extracted list, inside and around its range
+        {
+            extracted.emplace(150 + i % 300, 10000 + i);
+            extractedReference.emplace(150 + i % 300, 10000 + i);
+        }
+        for (int i = 0; i != 300; i++) // back into the gap of the first one
+        {
+            list->emplace(200 + i % 200, 20000 + i);
+            reference.emplace(200 + i % 200, 20000 + i);
+        }
+        CHECK(extracted.erase(300) == (int)extractedReference.erase(300));
+        extracted.erase(extracted.begin(), extracted.lower_bound(250));
+        extractedReference.erase(extractedReference.begin(), extractedReference.lower_bound(250));
+        CHECK(sameIndex(*list, reference));
+        CHECK(sameIndex(extracted, extractedReference));
+
+        delete list; // the extracted nodes have to outlive it
+        for (int i = 0; i != 300; i++)
+        {
+            extracted.emplace(i, 30000 + i); // reuses the blocks freed above
+            extractedReference.emplace(i, 30000 + i);
+        }
+        CHECK(sameIndex(extracted, extractedReference));
+    }
+    cout << "RANGE ERASE [END]..." << endl;
+
+    cout << "SPLIT, JOIN AND MERGE [START]..." << endl;
+    /* SPLIT_AT THEN JOIN: the round trip gives back the same list, with the same ranks */
+    {
+        typedef SkipList<int, int> List;
+        typedef multimap<int, int> Map;
+        List list;
+        Map reference;
+        fillRuns(list, reference, 1000, 0);
+
+        const int keys[] = { -5, 0, 1, 500, 999, 1000, 2000 }; // before, on and behind the elts
+        for (int key : keys)
+        {
+            List upper = list.split_at(key);
+            Map upperReference(reference.lower_bound(key), reference.end());
+            Map lowerReference(reference.begin(), reference.lower_bound(key));
+            CHECK(sameIndex(list, lowerReference));
+            CHECK(sameIndex(upper, upperReference));
+
+            list.join(upper);
+            CHECK(upper.empty() && sameIndex(upper, Map()));
+            CHECK(sameIndex(list, reference));
+        }
+
+        // split the halves again and insert into them before joining back
+        List upper = list.split_at(700);
+        List middle = list.split_at(300);
+        for (int i = 0; i != 300; i++)
+        {
+            middle.emplace(300 + i, 10000 + i);
+            reference.emplace(300 + i, 10000 + i);
+        }
+        middle.join(upper);
+        list.join(middle);
+        CHECK(sameIndex(list, reference));
+    }
+
+    /* MERGE OF OVERLAPPING RANGES: equal keys keep our elts first (join() falls back to it) */
+    {
+        typedef SkipList<int, int> List;
+        typedef multimap<int, int> Map;
+        List ours;
+        List theirs;
+        Map reference;
+        fillRuns(ours, reference, 500, 0);
+        for (int i = 0; i != 1500; i++)
+        {
+            theirs.emplace(250 + i % 500, 10000 + i);
+            reference.emplace(250 + i % 500, 10000 + i); // behind ours in the multimap too
+        }
+
+        ours.merge(theirs);
+        CHECK(theirs.empty());
+        CHECK(sameIndex(ours, reference));
+
+        fillRuns(theirs, reference, 100, 20000);
+        ours.join(theirs);
+        CHECK(theirs.empty());
+        CHECK(sameIndex(ours, reference));
+
+        theirs.emplace(1, 1); // the emptied list is still usable
+        CHECK(theirs.size() == 1 && theirs.begin()->second == 1);
+    }
+
+    /* JOIN AND MERGE FROM A LIST WITH A HIGHER MAXHEIGHT: its towers are cut down to ours */
+    {
+        typedef SkipList<int, int> List;
+        typedef multimap<int, int> Map;
+        List low(6);
+        Map reference;
+        fillRuns(low, reference, 100, 0);
+
+        List high(32);
+        for (int i = 0; i != 5000; i++)
+        {
+            high.emplace(100 + i, i);
+            reference.emplace(100 + i, i);
+        }
+        low.join(high);
+        CHECK(high.empty());
+        CHECK(sameIndex(low, reference));
+
+        List higher(40);
+        for (int i = 0; i != 5000; i++)
+        {
+            higher.emplace(i * 3, 50000 + i);
+            reference.emplace(i * 3, 50000 + i);
+        }
+        low.merge(higher);
+        CHECK(sameIndex(low, reference));
+
+        // the cut towers go back to the arena as smaller blocks, reuse them
+        mt19937 random(5);
+        for (int i = 0; i != 10000; i++)
+        {
+            int key = uniform_int_distribution<int>(0, 15000)(random);
+            if (i % 2 == 0)
+            {
+                CHECK(low.erase(key) == (int)reference.erase(key));
+            }
+            else
+            {
+                low.emplace(key, 100000 + i);
+                reference.emplace(key, 100000 + i);
+            }
+        }
+        CHECK(sameIndex(low, reference));
+    }
+    cout << "SPLIT, JOIN AND MERGE [END]..." << endl;
+
+    cout << "SIMD KEY SEARCH [START]..." << endl;
+    /* VECTOR KERNELS AND THE LISTS SEARCHING WITH THEM, against the scalar results (the same checks hold with SKIPLIST_NO_SIMD) */
+    checkKeyType<int>();
+    checkKeyType<long long>();
+    checkKeyType<float>();
+    checkKeyType<double>();
+    cout << "SIMD KEY SEARCH [END]..." << endl;
+
+    cout << (failures == 0 ? "ALL PASSED" : "SOME FAILED") << endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,306 @@
+#ifndef SIMDKEYSEARCH_H
+#define SIMDKEYSEARCH_H
+
+#include <functional> // greater, less
+#include <limits> // numeric_limits
+
+// instruction sets (define SKIPLIST_NO_SIMD to force the scalar code)
+#if !defined(SKIPLIST_NO_SIMD)
+#if defined(__AVX2__)
+#define SKIPLIST_SIMD_AVX2
+#define SKIPLIST_SIMD_SSE2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SKIPLIST_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+#if defined(__SSE4_2__) && !defined(SKIPLIST_SIMD_AVX2)
+#include <nmmintrin.h> // _mm_cmpgt_epi64
+#endif
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h> // _BitScanReverse, __popcnt
+#endif
+
+
+/*
+ * one vector compare of a search key against SimdLanes<Key>::count consecutive keys, bit l of the mask is set if keys[l] <op> key
+ * count is 0 if the target has no vector compare for Key (everything goes through the scalar loop then)
+*/
+enum SimdKeyOp { simdLess, simdLessEqual, simdGreater, simdGreaterEqual };
+
+template <typename Key> struct SimdLanes
+{
+    static constexpr int count = 0;
+    static unsigned int mask(const Key*, Key, SimdKeyOp) { return 0; }
+};
+
+#if defined(SKIPLIST_SIMD_AVX2)
+template <> struct SimdLanes<int>
+{
+    static constexpr int count = 8;
+    static unsigned int mask(const int* keys, int key, SimdKeyOp op)
+    {
+        const __m256i k = _mm256_set1_epi32(key);
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys));
+        __m256i c;
+        switch (op)
+        {
+        case simdLess: c = _mm256_cmpgt_epi32(k, v); break;
+        case simdLessEqual: c = _mm256_xor_si256(_mm256_cmpgt_epi32(v, k), _mm256_set1_epi32(-1)); break;
+        case simdGreater: c = _mm256_cmpgt_epi32(v, k); break;
+        default: c = _mm256_xor_si256(_mm256_cmpgt_epi32(k, v), _mm256_set1_epi32(-1)); break;
+        }
+        return static_cast<unsigned int>(_mm256_movemask_ps(_mm256_castsi256_ps(c)));
+    }
+};
+
+template <> struct SimdLanes<long long>
+{
+    static constexpr int count = 4;
+    static unsigned int mask(const long long* keys, long long key, SimdKeyOp op)
+    {
+        const __m256i k = _mm256_set1_epi64x(key);
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys));
+        __m256i c;
+        switch (op)
+        {
+        case simdLess: c = _mm256_cmpgt_epi64(k, v); break;
+        case simdLessEqual: c = _mm256_xor_si256(_mm256_cmpgt_epi64(v, k), _mm256_set1_epi64x(-1)); break;
+        case simdGreater: c = _mm256_cmpgt_epi64(v, k); break;
+        default: c = _mm256_xor_si256(_mm256_cmpgt_epi64(k, v), _mm256_set1_epi64x(-1)); break;
+        }
+        return static_cast<unsigned int>(_mm256_movemask_pd(_mm256_castsi256_pd(c)));
+    }
+};
+
+template <> struct SimdLanes<float>
+{
+    static constexpr int count = 8;
+    static unsigned int mask(const float* keys, float key, SimdKeyOp op)
+    {
+        const __m256 k = _mm256_set1_ps(key);
+        const __m256 v = _mm256_loadu_ps(keys);
+        __m256 c;
+        switch (op)
+        {
+        case simdLess: c = _mm256_cmp_ps(v, k, _CMP_LT_OQ); break;
+        case simdLessEqual: c = _mm256_cmp_ps(v, k, _CMP_LE_OQ); break;
+        case simdGreater: c = _mm256_cmp_ps(v, k, _CMP_GT_OQ); break;
+        default: c = _mm256_cmp_ps(v, k, _CMP_GE_OQ); break;
+        }
+        return static_cast<unsigned int>(_mm256_movemask_ps(c));
+    }
+};
+
+template <> struct SimdLanes<double>
+{
+    static constexpr int count = 4;
+    static unsigned int mask(const double* keys, double key, SimdKeyOp op)
+    {
+        const __m256d k = _mm256_set1_pd(key);
+        const __m256d v = _mm256_loadu_pd(keys);
+        __m256d c;
+        switch (op)
+        {
+        case simdLess: c = _mm256_cmp_pd(v, k, _CMP_LT_OQ); break;
+        case simdLessEqual: c = _mm256_cmp_pd(v, k, _CMP_LE_OQ); break;
+        case simdGreater: c = _mm256_cmp_pd(v, k, _CMP_GT_OQ); break;
+        default: c = _mm256_cmp_pd(v, k, _CMP_GE_OQ); break;
+        }
+        return static_cast<unsigned int>(_mm256_movemask_pd(c));
+    }
+};
+#elif defined(SKIPLIST_SIMD_SSE2)
+template <> struct SimdLanes<int>
+{
+    static constexpr int count = 4;
+    static unsigned int mask(const int* keys, int key, SimdKeyOp op)
+    {
+        const __m128i k = _mm_set1_epi32(key);
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys));
+        __m128i c;
+        switch (op)
+        {
+        case simdLess: c = _mm_cmplt_epi32(v, k); break;
+        case simdLessEqual: c = _mm_xor_si128(_mm_cmpgt_epi32(v, k), _mm_set1_epi32(-1)); break;
+        case simdGreater: c = _mm_cmpgt_epi32(v, k); break;
+        default: c = _mm_xor_si128(_mm_cmplt_epi32(v, k), _mm_set1_epi32(-1)); break;
+        }
+        return static_cast<unsigned int>(_mm_movemask_ps(_mm_castsi128_ps(c)));
+    }
+};
+
+#if defined(__SSE4_2__)
+template <> struct SimdLanes<long long>
+{
+    static constexpr int count = 2;
+    static unsigned int mask(const long long* keys, long long key, SimdKeyOp op)
+    {
+        const __m128i k = _mm_set1_epi64x(key);
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys));
+        __m128i c;
+        switch (op)
+        {
+        case simdLess: c = _mm_cmpgt_epi64(k, v); break;
+        case simdLessEqual: c = _mm_xor_si128(_mm_cmpgt_epi64(v, k), _mm_set1_epi64x(-1)); break;
+        case simdGreater: c = _mm_cmpgt_epi64(v, k); break;
+        default: c = _mm_xor_si128(_mm_cmpgt_epi64(k, v), _mm_set1_epi64x(-1)); break;
+        }
+        return static_cast<unsigned int>(_mm_movemask_pd(_mm_castsi128_pd(c)));
+    }
+};
+#endif
+
+template <> struct SimdLanes<float>
+{
+    static constexpr int count = 4;
+    static unsigned int mask(const float* keys, float key, SimdKeyOp op)
+    {
+        const __m128 k = _mm_set1_ps(key);
+        const __m128 v = _mm_loadu_ps(keys);
+        __m128 c;
+        switch (op)
+        {
+        case simdLess: c = _mm_cmplt_ps(v, k); break;
+        case simdLessEqual: c = _mm_cmple_ps(v, k); break;
+        case simdGreater: c = _mm_cmpgt_ps(v, k); break;
+        default: c = _mm_cmpge_ps(v, k); break;
+        }
+        return static_cast<unsigned int>(_mm_movemask_ps(c));
+    }
+};
+
+template <> struct SimdLanes<double>
+{
+    static constexpr int count = 2;
+    static unsigned int mask(const double* keys, double key, SimdKeyOp op)
+    {
+        const __m128d k = _mm_set1_pd(key);
+        const __m128d v = _mm_loadu_pd(keys);
+        __m128d c;
+        switch (op)
+        {
+        case simdLess: c = _mm_cmplt_pd(v, k); break;
+        case simdLessEqual: c = _mm_cmple_pd(v, k); break;
+        case simdGreater: c = _mm_cmpgt_pd(v, k); break;
+        default: c = _mm_cmpge_pd(v, k); break;
+        }
+        return static_cast<unsigned int>(_mm_movemask_pd(c));
+    }
+};
+#endif
+
+inline int simdHighestBit(unsigned int mask) // index of the highest set bit, mask must not be 0
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse(&index, mask);
+    return static_cast<int>(index);
+#else
+    return 31 - __builtin_clz(mask);
+#endif
+}
+
+template <typename Key>
+int simdHighest(const Key* keys, int count, Key key, SimdKeyOp op) // highest l < @count with keys[l] <op> key, -1 if there is none
+{
+    // whole vectors from the top down, a skip list search wants the highest level anyway
+    for (; count >= SimdLanes<Key>::count && SimdLanes<Key>::count != 0; count -= SimdLanes<Key>::count)
+    {
+        unsigned int mask = SimdLanes<Key>::mask(keys + count - SimdLanes<Key>::count, key, op);
+        if (mask != 0)
+            return count - SimdLanes<Key>::count + simdHighestBit(mask);
+    }
+
+    // the levels below the last full vector (and everything on targets without SIMD)
+    for (int l = count - 1; l >= 0; l--)
+    {
+        switch (op)
+        {
+        case simdLess: if (keys[l] < key) return l; break;
+        case simdLessEqual: if (keys[l] <= key) return l; break;
+        case simdGreater: if (keys[l] > key) return l; break;
+        case simdGreaterEqual: if (keys[l] >= key) return l; break;
+        }
+    }
+    return -1;
+}
+
+template <typename Key>
+int simdCount(const Key* keys, int count, Key key, SimdKeyOp op) // number of l < @count with keys[l] <op> key
+{
+    int found = 0;
+    int l = 0;
+    for (; l + SimdLanes<Key>::count <= count && SimdLanes<Key>::count != 0; l += SimdLanes<Key>::count)
+    {
+        unsigned int mask = SimdLanes<Key>::mask(keys + l, key, op);
+#if defined(_MSC_VER)
+        found += static_cast<int>(__popcnt(mask));
+#else
+        found += __builtin_popcount(mask);
+#endif
+    }
+
+    for (; l < count; l++)
+    {
+        switch (op)
+        {
+        case simdLess: found += keys[l] < key; break;
+        case simdLessEqual: found += keys[l] <= key; break;
+        case simdGreater: found += keys[l] > key; break;
+        case simdGreaterEqual: found += keys[l] >= key; break;
+        }
+    }
+    return found;
+}
+
+/*
+ * SimdKeySearch<Key, Compare>
+ * picks the dense key search at compile time: int, long long, float and double keys ordered by std::greater
+ * (ascending, the default) or std::less (descending) can be kept in key-only arrays and compared several at a time.
+ * UnrolledSkipList mirrors the keys of every block that way, SkipList (with SKIPLIST_SIMD_TOWERS) the keys of the
+ * next nodes of every tower. every other Key/Compare combination keeps the scalar search (enabled == false).
+*/
+template <typename Key, class Compare> struct SimdKeySearch
+{
+    static constexpr bool enabled = false;
+};
+
+template <typename Key, bool Ascending> struct DenseKeySearch
+{
+    static constexpr bool enabled = true;
+
+    static Key sentinel() // cached key of the tail: NaN never goes before anything, the integer extremes need the tail check in the search
+    {
+        if (std::numeric_limits<Key>::has_quiet_NaN)
+            return std::numeric_limits<Key>::quiet_NaN();
+        return Ascending ? std::numeric_limits<Key>::max() : std::numeric_limits<Key>::lowest();
+    }
+
+    static int countBefore(const Key* keys, int count, Key key, bool upper) // number of keys[0 .. count-1] going before @key (upper: or equivalent to it), branch free
+    {
+        if (Ascending)
+            return simdCount(keys, count, key, upper ? simdLessEqual : simdLess);
+        return simdCount(keys, count, key, upper ? simdGreaterEqual : simdGreater);
+    }
+
+    static int highestBefore(const Key* keys, int count, Key key, bool upper) // highest l < @count whose keys[l] goes before @key (upper: or is equivalent to it), -1 if none
+    {
+        if (Ascending)
+            return simdHighest(keys, count, key, upper ? simdLessEqual : simdLess);
+        return simdHighest(keys, count, key, upper ? simdGreaterEqual : simdGreater);
+    }
+};
+
+template <> struct SimdKeySearch<int, std::greater<int> > : DenseKeySearch<int, true> { };
+template <> struct SimdKeySearch<int, std::less<int> > : DenseKeySearch<int, false> { };
+template <> struct SimdKeySearch<long long, std::greater<long long> > : DenseKeySearch<long long, true> { };
+template <> struct SimdKeySearch<long long, std::less<long long> > : DenseKeySearch<long long, false> { };
+template <> struct SimdKeySearch<float, std::greater<float> > : DenseKeySearch<float, true> { };
+template <> struct SimdKeySearch<float, std::less<float> > : DenseKeySearch<float, false> { };
+template <> struct SimdKeySearch<double, std::greater<double> > : DenseKeySearch<double, true> { };
+template <> struct SimdKeySearch<double, std::less<double> > : DenseKeySearch<double, false> { };
+
+#endif // SIMDKEYSEARCH_H
@@ -3,44 +3,81 @@
 
 #include <functional> // greater
 #include <iterator> // bidirectional_iterator_tag
-#include <utility> // pair
-#include <random> // uniform_real_distribution, default_random_engine
-#include <cmath> // frexp
+#include <utility> // pair, forward, piecewise_construct
+#include <tuple> // forward_as_tuple
+#include <cstdint> // uint64_t
 #include <iostream> // cout
 #include <stdexcept> // std::out_of_range
-
-
-template <typename Key, typename T, class Compare = greater<Key> > class SkipList
+#include <new> // placement new
+#include <cstddef> // size_t
+#include <cstring> // memmove
+#include <memory> // allocator, allocator_traits
+#include <type_traits> // is_trivially_destructible
+#include <algorithm> // min, max, is_sorted, find
+#include <vector> // vector
+#include <thread> // thread, hardware_concurrency
+#include <exception> // exception_ptr
+
+#include "simdkeysearch.h"
+#include "levelgenerator.h"
+#include "frozenskiplist.h"
+
+#if defined(__GNUC__) || defined(__clang__)
+#define SKIPLIST_PREFETCH(address) __builtin_prefetch(address)
+#elif defined(_MSC_VER)
+#include <xmmintrin.h> // _mm_prefetch
+#define SKIPLIST_PREFETCH(address) _mm_prefetch(reinterpret_cast<const char*>(address), _MM_HINT_T0)
+#else
+#define SKIPLIST_PREFETCH(address) ((void)0)
+#endif
+
+// operation counters for stats(), define SKIPLIST_STATS to keep them (compiled out otherwise)
+#if defined(SKIPLIST_STATS)
+#define SKIPLIST_COUNT(counter, n) (counters.counter += (n))
+#else
+#define SKIPLIST_COUNT(counter, n) ((void)0)
+#endif
+
+template <typename Key, typename T, class Compare = std::greater<Key>, class Allocator = std::allocator<std::pair<Key, T> >, class Levels = GeometricLevels<> > class SkipList
 {
 public:
+    typedef int size_type;
+    typedef SimdKeySearch<Key, Compare> KeySearch;
+#if defined(SKIPLIST_SIMD_TOWERS)
+    static constexpr bool cachedKeys = KeySearch::enabled; // towers carry the keys of their next nodes, searched with SIMD
+#else
+    static constexpr bool cachedKeys = false; // opt-in: with p = 1/2 most steps decide on the first level, so this rarely beats the scalar descent
+#endif
+#if defined(SKIPLIST_SINGLE_LINKED_TOWERS)
+    static constexpr bool backLinks = false; // prev only on level 0: a third less tower memory, erase(iterator) and emplace_hint search for the predecessors
+#else
+    static constexpr bool backLinks = true; // prev on every level
+#endif
+
     struct Node
     {
         std::pair<Key, T> pair;
-        Node** next; // aray of ptrs
-        Node** prev; // aray of ptrs
         int height; // height of this node
 
-        Node() { }
-        Node(int level) : height(level + 1)
-        {
-            next = new Node*[level + 1];
-            prev = new Node*[level + 1];
-        }
-        Node(std::pair<Key, T> KeyValuePair, int level) : Node(level)
-        {
-            pair(KeyValuePair);
-        }
-
-        Node(Key key, T value, int level) : Node(level)
-        {
-            pair.first = key;
-            pair.second = value;
-        }
-
-        ~Node()
+        template<class... Args>
+        Node(int level, Args&&... args) : pair(std::forward<Args>(args)...), height(level + 1) { } // the pair is built in place from @args
+
+        // the tower lives inline, right behind the node, in the same allocation:
+        // [ Node | next[0 .. height-1] | prev[0 .. height-1] (prev[0] only, without backLinks) | width[0 .. height-1] (| nextKeys[0 .. height-1]) ]
+        Node** next() { return reinterpret_cast<Node**>(reinterpret_cast<char*>(this) + towerOffset()); } // aray of ptrs
+        Node** prev() { return next() + height; } // aray of ptrs
+        size_type* width() { return reinterpret_cast<size_type*>(prev() + prevCount(height)); } // level 0 steps covered by next[i]
+        Key* nextKeys() { return reinterpret_cast<Key*>(reinterpret_cast<char*>(this) + keysOffset(height)); } // key of next[i], only there if cachedKeys
+
+        static constexpr int prevCount(int height) { return backLinks ? height : 1; }
+        static constexpr std::size_t towerOffset() { return (sizeof(Node) + alignof(Node*) - 1) / alignof(Node*) * alignof(Node*); }
+        static std::size_t towerSize(int height) { return (height + prevCount(height)) * sizeof(Node*) + height * sizeof(size_type); }
+        static std::size_t keysOffset(int height) { return (towerOffset() + towerSize(height) + alignof(Key) - 1) / alignof(Key) * alignof(Key); }
+        static std::size_t blockSize(int level) // bytes needed for a node of this level
         {
-            delete[] next;
-            delete[] prev;
+            if (cachedKeys)
+                return keysOffset(level + 1) + (level + 1) * sizeof(Key);
+            return towerOffset() + towerSize(level + 1);
         }
     };
 
@@ -52,12 +89,12 @@ public:
         Node* it;
     public:
         iterator(Node* node = NULL) : it(node) { }
-        iterator operator++(int) { it = it->next[0]; return it; }
-        iterator& operator++() { it = it->next[0]; return iteratori(it); }
-        iterator operator--(int) { it = it->prev[0]; return it; }
-        iterator& operator--() { it = it->prev[0]; return iterator(it); }
-        bool operator==(iterator& other) const { return it == other.it; }
-        bool operator!=(iterator& other) const { return it != other.it; }
+        iterator operator++(int) { it = it->next()[0]; return it; }
+        iterator& operator++() { it = it->next()[0]; return *this; }
+        iterator operator--(int) { it = it->prev()[0]; return it; }
+        iterator& operator--() { it = it->prev()[0]; return *this; }
+        bool operator==(const iterator& other) const { return it == other.it; }
+        bool operator!=(const iterator& other) const { return it != other.it; }
         std::pair<Key, T>& operator*() const { return it->pair; }
         std::pair<Key, T>* operator->() const { return &it->pair; }
 
@@ -69,451 +106,2097 @@ public:
         using iterator_category = std::bidirectional_iterator_tag;
     };
 
-    typedef int size_type;
+    typedef Allocator allocator_type;
+
+    static constexpr int levelLimit = 64; // upper bound for maxLevels
+
+    // remembers the path of the last search made through it, so the next search can start from there (finger search)
+    class finger
+    {
+        friend class SkipList;
+    private:
+        const SkipList* list = NULL; // list the path belongs to
+        unsigned long generation = 0; // list generation the path was taken in
+        int height = 0; // number of valid levels in path
+        Node* path[levelLimit]; // last node in front of the searched position, on every level
+    };
+
+    // snapshot taken by stats(); the operation counters are only kept with SKIPLIST_STATS, they stay 0 otherwise
+    struct statistics
+    {
+        size_type size = 0; // number of elts
+        int height = 0; // levels in use
+        size_type levels[levelLimit] = { }; // levels[i]: towers of height i + 1
+        std::size_t memory = 0; // bytes of node memory held: the arena's chunks (and the ones it keeps alive for nodes taken over), the sentinels
+        std::uint64_t searches = 0; // searches from the head or a finger (find, bounds, count, insertions, erase by key)
+        std::uint64_t steps = 0; // links followed to the right by those searches, steps / searches is the average path length
+        std::uint64_t comparisons = 0; // key comparisons made by those searches (one per tower with SKIPLIST_SIMD_TOWERS)
+        std::uint64_t hints = 0; // emplace_hint calls (insert with a position included)
+        std::uint64_t hintMisses = 0; // hints that were not used, the elt was inserted with a full search
+    };
 
-    SkipList(unsigned int maxLevels = 42); // 42 is surely the best option :>
+    SkipList(unsigned int maxLevels = 32, const Allocator& allocator = Allocator()); // 32 levels cover 2^31 elts at p = 1/2, the levels in use grow with the size
+    template<class InputIterator>
+    SkipList(InputIterator first, InputIterator last, unsigned int maxLevels = 32, const Allocator& allocator = Allocator()); // builds the list from a (preferably sorted) range
+    SkipList(SkipList&& other); // takes over the elts, @other is left empty
+    SkipList(const SkipList&) = delete;
+    SkipList& operator=(const SkipList&) = delete;
     ~SkipList();
 
-    typename SkipList<Key, T, Compare>::iterator emplace(const Key key, const T value);
-    inline typename SkipList<Key, T, Compare>::iterator emplace(const std::pair<Key, T> pair);
-    inline typename SkipList<Key, T, Compare>::iterator insert(const std::pair<Key, T> pair);
-    inline typename SkipList<Key, T, Compare>::iterator insert(const Key key, const T value);
-    inline typename SkipList<Key, T, Compare>::iterator insert(const typename SkipList<Key, T, Compare>::iterator position, const Key key, T value);
-    inline typename SkipList<Key, T, Compare>::iterator insert(const typename SkipList<Key, T, Compare>::iterator position, const std::pair<Key, T> pair);
+    // the elt is constructed in place from the arguments (key + value, a pair, or std::piecewise_construct + 2 tuples)
+    template<class... Args>
+    typename SkipList<Key, T, Compare, Allocator, Levels>::iterator emplace(Args&&... args);
+    inline typename SkipList<Key, T, Compare, Allocator, Levels>::iterator insert(const std::pair<Key, T>& pair);
+    inline typename SkipList<Key, T, Compare, Allocator, Levels>::iterator insert(std::pair<Key, T>&& pair);
+    inline typename SkipList<Key, T, Compare, Allocator, Levels>::iterator insert(const Key& key, const T& value);
+    inline typename SkipList<Key, T, Compare, Allocator, Levels>::iterator insert(Key&& key, T&& value);
+    inline typename SkipList<Key, T, Compare, Allocator, Levels>::iterator insert(const typename SkipList<Key, T, Compare, Allocator, Levels>::iterator position, const Key& key, const T& value);
+    inline typename SkipList<Key, T, Compare, Allocator, Levels>::iterator insert(const typename SkipList<Key, T, Compare, Allocator, Levels>::iterator position, Key&& key, T&& value);
+    inline typename SkipList<Key, T, Compare, Allocator, Levels>::iterator insert(const typename SkipList<Key, T, Compare, Allocator, Levels>::iterator position, const std::pair<Key, T>& pair);
+    inline typename SkipList<Key, T, Compare, Allocator, Levels>::iterator insert(const typename SkipList<Key, T, Compare, Allocator, Levels>::iterator position, std::pair<Key, T>&& pair);
+
+    // inserts only if no elt has an equivalent key (@args are left untouched otherwise), the value is built from @args
+    template<class... Args>
+    std::pair<typename SkipList<Key, T, Compare, Allocator, Levels>::iterator, bool> try_emplace(const Key& key, Args&&... args);
+    template<class... Args>
+    std::pair<typename SkipList<Key, T, Compare, Allocator, Levels>::iterator, bool> try_emplace(Key&& key, Args&&... args);
 
     template<class InputIterator>
     void insert(InputIterator first, InputIterator last);
+    template<class InputIterator>
+    void assign_sorted(InputIterator first, InputIterator last);
+    template<class InputIterator>
+    void parallel_build(InputIterator first, InputIterator last, unsigned int threads = 0); // replaces the contents, sorting and linking on @threads threads (0: one per hardware thread)
+    void clear();
+
+    template<class... Args>
+    typename SkipList<Key, T, Compare, Allocator, Levels>::iterator emplace_hint(const typename SkipList<Key, T, Compare, Allocator, Levels>::iterator position, Args&&... args);
+    typename SkipList<Key, T, Compare, Allocator, Levels>::iterator find(const Key& key);
+    typename SkipList<Key, T, Compare, Allocator, Levels>::iterator lower_bound(const Key& key) const;
+    typename SkipList<Key, T, Compare, Allocator, Levels>::iterator upper_bound(const Key& key) const;
+    std::pair<typename SkipList<Key, T, Compare, Allocator, Levels>::iterator, typename SkipList<Key, T, Compare, Allocator, Levels>::iterator> equal_range(const Key& key) const;
+    size_type count(const Key& key) const;
+
+    // heterogeneous lookup: with a transparent Compare (e.g. std::greater<>) any type comparable with Key is accepted as is
+    template<class K, class C = Compare, class = typename C::is_transparent>
+    typename SkipList<Key, T, Compare, Allocator, Levels>::iterator find(const K& key);
+    template<class K, class C = Compare, class = typename C::is_transparent>
+    typename SkipList<Key, T, Compare, Allocator, Levels>::iterator lower_bound(const K& key) const;
+    template<class K, class C = Compare, class = typename C::is_transparent>
+    typename SkipList<Key, T, Compare, Allocator, Levels>::iterator upper_bound(const K& key) const;
+    template<class K, class C = Compare, class = typename C::is_transparent>
+    std::pair<typename SkipList<Key, T, Compare, Allocator, Levels>::iterator, typename SkipList<Key, T, Compare, Allocator, Levels>::iterator> equal_range(const K& key) const;
+    template<class K, class C = Compare, class = typename C::is_transparent>
+    size_type count(const K& key) const;
+    template<class K, class C = Compare, class = typename C::is_transparent>
+    size_type erase(const K& key);
+
+    // batched lookups: results[i] is find(keys[i]) / lower_bound(keys[i]), for keys in [first, last)
+    template<class RandomAccessIterator, class OutputIterator>
+    void find_batch(RandomAccessIterator first, RandomAccessIterator last, OutputIterator results) const;
+    template<class RandomAccessIterator, class OutputIterator>
+    void lower_bound_batch(RandomAccessIterator first, RandomAccessIterator last, OutputIterator results) const;
+    typename SkipList<Key, T, Compare, Allocator, Levels>::iterator erase(typename SkipList<Key, T, Compare, Allocator, Levels>::iterator it);
+    size_type erase(const Key& key);
+
+    // range removal: both ends are searched once and the range is spliced out level by level, O(log n + k)
+    typename SkipList<Key, T, Compare, Allocator, Levels>::iterator erase(const typename SkipList<Key, T, Compare, Allocator, Levels>::iterator first, const typename SkipList<Key, T, Compare, Allocator, Levels>::iterator last);
+    size_type erase_range(const Key& lo, const Key& hi);
+    SkipList extract_range(const Key& lo, const Key& hi);
+
+    // priority queue use: the first elts are cut off head directly, without searching for their predecessors
+    std::pair<Key, T>& front() const; // first elt, the list must not be empty
+    void pop_front(); // removes the first elt (if any) in O(its height)
+    size_type pop_front_n(size_type k); // removes the first @k elts (or all of them), O(log k + k)
+    size_type erase_until(const Key& key); // removes the elts whose key goes before @key, returns how many
+
+    // moving elts between lists: the towers are relinked, the nodes are not reallocated
+    SkipList split_at(const Key& key);
+    void join(SkipList& other);
+    void merge(SkipList& other);
+
+    // finger search: O(log d) in the distance d from the previous search made through @from
+    typename SkipList<Key, T, Compare, Allocator, Levels>::iterator find(finger& from, const Key& key) const;
+    typename SkipList<Key, T, Compare, Allocator, Levels>::iterator lower_bound(finger& from, const Key& key) const;
+    typename SkipList<Key, T, Compare, Allocator, Levels>::iterator upper_bound(finger& from, const Key& key) const;
+    size_type erase(finger& from, const Key& key);
+
+    typename SkipList<Key, T, Compare, Allocator, Levels>::iterator begin() const;
+    typename SkipList<Key, T, Compare, Allocator, Levels>::iterator end() const;
+    bool empty() const;
+    size_type size() const;
+    allocator_type get_allocator() const;
+    void seed(std::uint64_t value); // reseeds the level generator, the same seed and the same operations give the same list
+    statistics stats() const;
 
-    typename SkipList<Key, T, Compare>::iterator emplace_hint(const typename SkipList<Key, T, Compare>::iterator position, const Key key, const T value);
-    inline typename SkipList<Key, T, Compare>::iterator emplace_hint(const typename SkipList<Key, T, Compare>::iterator position, const std::pair<Key, T> pair);
-    typename SkipList<Key, T, Compare>::iterator find(const Key key);
-    typename SkipList<Key, T, Compare>::iterator lower_bound(const Key key) const;
-    typename SkipList<Key, T, Compare>::iterator upper_bound(const Key key) const;
-    typename SkipList<Key, T, Compare>::iterator erase(typename SkipList<Key, T, Compare>::iterator it);
-    size_type erase(Key it);
+    // binary image, for trivially copyable Key and T (format in frozenskiplist.h, FrozenSkipList serves it in place)
+    void save(std::ostream& out, bool heights = false) const; // the elts in order (and their tower heights, so load() rebuilds the same towers)
+    void load(std::istream& in); // replaces the contents in one linear pass, throws std::runtime_error on a bad image (the list is left empty)
 
-    typename SkipList<Key, T, Compare>::iterator begin() const;
-    typename SkipList<Key, T, Compare>::iterator end() const;
-    bool empty() const;
+    // rank queries (ranks are 0-based positions in the sorted sequence)
+    typename SkipList<Key, T, Compare, Allocator, Levels>::iterator at_rank(size_type rank) const;
+    size_type rank_of(const typename SkipList<Key, T, Compare, Allocator, Levels>::iterator it) const;
+    size_type count_range(const Key& lo, const Key& hi) const;
+
+    // calls fn(elt) for every elt with a key in [lo, hi), on @threads threads (0: one per hardware thread) working on
+    // disjoint runs of about the same length; the list must not change meanwhile
+    template<class Function>
+    void parallel_for_each(const Key& lo, const Key& hi, Function fn, unsigned int threads = 0) const;
 
 private:
-    void debug() const;
+    /*
+     * slab arena for the nodes
+     * memory is requested from the Allocator in big chunks (counted in cache lines), nodes are bumped out of the
+     * current chunk and recycled through one free list per tower height (all nodes of a height have the same size).
+     * the chunks belong to ref-counted stores: a list that takes over nodes from another one (extract_range, split_at,
+     * join, merge) keeps the other's stores alive, so every list still has an arena of its own.
+    */
+    class Arena
+    {
+    public:
+        struct alignas(64) Line { unsigned char bytes[64]; }; // allocation unit
+        using LineAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Line>;
+        static constexpr int maxClasses = levelLimit; // one size class per tower height
 
-    const int maxHeight; // max num of levels ("height")
-    int currentHeight = 0; // current "height" of skip-list
-    Node* head; // head of skiplist
-    Node* tail; // tail of skiplist
+        class Store // chunks of node memory, given back when the last arena holding them goes away
+        {
+        public:
+            Store(const LineAllocator& allocator) : allocator(allocator) { }
+            Store(const Store&) = delete;
+            Store& operator=(const Store&) = delete;
+            ~Store()
+            {
+                while (chunks != NULL)
+                {
+                    Chunk* next = chunks->next;
+                    std::size_t lines = chunks->lines;
+                    std::allocator_traits<LineAllocator>::deallocate(allocator, reinterpret_cast<Line*>(chunks), lines);
+                    chunks = next;
+                }
+            }
 
-     // random
-     std::default_random_engine generator;
-};
+            Line* grow(std::size_t lines) // requests a new chunk of @lines, returns the memory behind its header
+            {
+                Line* memory = std::allocator_traits<LineAllocator>::allocate(allocator, lines);
+                Chunk* chunk = reinterpret_cast<Chunk*>(memory);
+                chunk->next = chunks;
+                chunk->lines = lines;
+                chunks = chunk;
+                totalLines += lines;
+                return memory + 1; // skip the header
+            }
 
-/** implementation **/
+            std::size_t bytes() const { return totalLines * sizeof(Line); }
 
-template<typename Key, typename T, class Compare>
-SkipList<Key, T, Compare>::SkipList(unsigned int maxHeight) : maxHeight(maxHeight) // initialises a skiplist with the specified level height
-{
-    // init space for head and tail
-    head = new Node(maxHeight);
-    tail = new Node(maxHeight);
+        private:
+            struct Chunk { Chunk* next; std::size_t lines; }; // header, lives in the first line of every chunk
 
-    // init head and tail pointers
-    head->prev = NULL;
-    tail->next = NULL;
-    for (int i = 0; i != maxHeight; i++)
-    {
-        head->next[i] = tail;
-        tail->prev[i] = head;
-    }
-}
+            LineAllocator allocator;
+            Chunk* chunks = NULL;
+            std::size_t totalLines = 0;
+        };
 
-template<typename Key, typename T, class Compare>
-SkipList<Key, T, Compare>::~SkipList()
-{
-    Node* it = head;
-    Node* next;
-    while (it != tail)
-    {
-        next = it->next[0];
-        delete it;
-        it = next;
-    }
+        Arena(const Allocator& allocator) : allocator(allocator), kept(allocator) { }
+        Arena(Arena&& other) : allocator(other.allocator), store(std::move(other.store)), kept(std::move(other.kept)), cursor(other.cursor), chunkEnd(other.chunkEnd), nextChunkLines(other.nextChunkLines)
+        {
+            std::copy(other.freeLists, other.freeLists + maxClasses, freeLists);
+            other.release();
+        }
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
 
-    delete tail;
-}
+        void* allocate(int level, std::size_t bytes) // returns a block for a node of @level
+        {
+            // recycle ?
+            if (freeLists[level] != NULL)
+            {
+                FreeBlock* block = freeLists[level];
+                freeLists[level] = block->next;
+                return block;
+            }
 
-template<typename Key, typename T, class Compare>
-typename SkipList<Key, T, Compare>::iterator SkipList<Key, T, Compare>::emplace(const Key key, const T value) // inserts a new node
-{
-    std::uniform_real_distribution<double> distribution(0.0, 1.0);
-    double p = distribution(generator); // [0, 1)
+            std::size_t lines = (bytes + sizeof(Line) - 1) / sizeof(Line);
+            if (cursor + lines > chunkEnd)
+                grow(lines);
 
-    /*
-     * calculates the node's top level using a dice roll
-     * lvl = -log_2(p)
-    */
-    int lvl;
-    std::frexp(p, &lvl);
-    lvl = -lvl;
+            void* block = cursor;
+            cursor += lines;
+            return block;
+        }
 
-    if (lvl >= maxHeight)
-        lvl = maxHeight - 1;
-    if (lvl >= currentHeight)
-        currentHeight = lvl + 1;
+        void deallocate(void* block, int level) // puts a block back into the free list of its size class
+        {
+            FreeBlock* freeBlock = static_cast<FreeBlock*>(block);
+            freeBlock->next = freeLists[level];
+            freeLists[level] = freeBlock;
+        }
 
-    // insertion
-    Node* newNode = new Node(key, value, lvl); // creation
-    Node* it = head; // our node iterator
-    // iterate over levels, from top to bottom
-    for (int i = currentHeight - 1; i >= 0; i--)
-    {
-        // iterate throught the current level, from left to right
-        for (it; it->next[i] != tail; it = it->next[i])
+        void recycle(Line* spare, std::size_t count, int levels) // cuts @count spare lines into free blocks of the levels under @levels, largest first (a rest smaller than any block is lost)
         {
-            if(Compare()(it->next[i]->pair.first, key))
-                break;
+            for (int level = levels - 1; level >= 0; )
+            {
+                std::size_t blockLines = lines(level);
+                if (blockLines > count)
+                {
+                    level--;
+                    continue;
+                }
+
+                deallocate(spare, level);
+                spare += blockLines;
+                count -= blockLines;
+            }
         }
 
-        // rebind the pointers ?
-        if (i <= lvl)
+        static std::size_t lines(int level) { return (Node::blockSize(level) + sizeof(Line) - 1) / sizeof(Line); } // size of the blocks of @level
+
+        void release() // lets go of all the memory, the chunks no other arena keeps alive go back to the allocator, O(chunks)
         {
-            newNode->next[i] = it->next[i];
-            it->next[i] = newNode;
+            store.reset();
+            kept.clear();
+            std::fill(freeLists, freeLists + maxClasses, static_cast<FreeBlock*>(NULL));
+            cursor = chunkEnd = NULL;
+        }
 
-            newNode->prev[i] = it;
-            newNode->next[i]->prev[i] = newNode;
+        std::size_t bytes() const // memory of our chunks and of the ones we keep alive (those may be shared with other lists)
+        {
+            std::size_t total = store != NULL ? store->bytes() : 0;
+            for (const std::shared_ptr<Store>& foreign : kept)
+                total += foreign->bytes();
+            return total;
         }
-    }
 
-    return newNode;
-}
+        void adopt(const Arena& other) // nodes of @other are about to move here, keep their memory alive as long as this arena
+        {
+            if (other.store != NULL)
+                keep(other.store);
+            for (const std::shared_ptr<Store>& foreign : other.kept)
+                keep(foreign);
+        }
 
-template<typename Key, typename T, class Compare>
-typename SkipList<Key, T, Compare>::iterator SkipList<Key, T, Compare>::emplace(const std::pair<Key, T> pair) // inserts a new node
-{
-    return emplace(pair.first, pair.second);
-}
+        LineAllocator allocator;
 
-// alias for emplace(pair)
-template<typename Key, typename T, class Compare>
-typename SkipList<Key, T, Compare>::iterator SkipList<Key, T, Compare>::insert(const std::pair<Key, T> pair) // inserts a new node
-{
-    return emplace(pair);
-}
+    private:
+        struct FreeBlock { FreeBlock* next; };
 
-// alias for emplace(key, value)
-template<typename Key, typename T, class Compare>
-typename SkipList<Key, T, Compare>::iterator SkipList<Key, T, Compare>::insert(const Key key, const T value) // inserts a new node
+        void grow(std::size_t lines) // requests a new chunk, big enough for at least @lines
+        {
+            std::size_t chunkLines = std::max(nextChunkLines, lines + 1);
+            nextChunkLines = std::min<std::size_t>(nextChunkLines * 2, maxChunkLines);
+
+            if (store == NULL)
+                store = std::allocate_shared<Store>(allocator, allocator);
+            cursor = store->grow(chunkLines);
+            chunkEnd = cursor - 1 + chunkLines;
+        }
+
+        void keep(const std::shared_ptr<Store>& foreign)
+        {
+            if (foreign != store && std::find(kept.begin(), kept.end(), foreign) == kept.end())
+                kept.push_back(foreign);
+        }
+
+        static constexpr std::size_t maxChunkLines = 16384; // 1 MiB
+
+        std::shared_ptr<Store> store; // where our chunks come from
+        std::vector<std::shared_ptr<Store>, typename std::allocator_traits<Allocator>::template rebind_alloc<std::shared_ptr<Store> > > kept; // stores of the nodes we took over
+        FreeBlock* freeLists[maxClasses] = { };
+        Line* cursor = NULL;
+        Line* chunkEnd = NULL;
+        std::size_t nextChunkLines = 64; // 4 KiB
+    };
+
+    void debug() const;
+
+    template<class... Args>
+    Node* createNode(int level, Args&&... args); // allocates a node (+ its tower) in a single, cache-line-aligned block
+    void destroyNode(Node* node);
+    Node* createSentinel(); // allocates a full height head/tail node, outside of the arena
+    void destroySentinel(Node* node);
+    void init(); // sets up head and tail
+    void linkSentinels(); // links head and tail to each other, on every level
+    void forgetNodes(); // empties the list without destroying the nodes (they moved to another list)
+    void shrinkTower(Node* node, int height); // drops the levels of @node from @height up, the lines it frees go to our arena
+    void fitTowers(SkipList& other); // cuts the towers of @other down to our maxHeight
+    void destroyNodes(); // runs the destructors of all the elts, leaves the memory to the arena
+
+    int randomLevel(); // rolls the level of a new node (and grows the list height if needed)
+    void growHeight(int level); // makes the list at least @level + 1 levels high
+    Node* insertNode(Node* newNode); // links a new node behind the elts with an equivalent key
+    Node* insertNode(Node* pos, Node* newNode); // same, searching from @pos, the elt in front of the insertion point
+    template<class K, class... Args>
+    std::pair<typename SkipList<Key, T, Compare, Allocator, Levels>::iterator, bool> tryEmplace(K&& key, Args&&... args);
+    inline void setNext(Node* node, int level, Node* next) const; // node->next()[level] = next, keeps the cached key in sync
+    void link(Node* newNode, Node* const* update, const size_type* rank); // links @newNode behind update[i] on every level
+    void unlink(Node* node); // takes @node out of every level
+    template<class K>
+    Node* descend(const K& key, bool upper, Node** update, size_type* rank) const; // returns the node in front of the lower (upper) bound
+    template<class K>
+    size_type countBefore(const K& key, bool upper = false) const; // number of elts whose key goes before @key (upper: does not go after it)
+    template<class K>
+    Node* findNode(const K& key) const; // first elt with a key equivalent to @key, tail if none
+    template<class K>
+    size_type eraseKey(const K& key);
+    void pathTo(Node* node, Node** update, size_type* rank) const; // the last node at or before @node on every level, and its rank
+    void rankPath(size_type target, Node** update, size_type* rank) const; // the last node with a rank up to @target on every level, and its rank
+    size_type rankOf(Node* node) const; // rank of @node, head is at rank 0
+    Node* cut(Node* const* left, const size_type* leftRank, Node* const* right, const size_type* rightRank, SkipList* into); // splices the nodes between two search paths out
+    size_type erasePrefix(Node* const* right, const size_type* rightRank); // removes the elts up to right[0] (a search path), returns how many
+    void lastNodes(Node** update, size_type* rank) const; // the last node on every level, and its rank
+    Node* fingerSearch(finger& from, const Key& key, bool upper) const; // returns the node in front of the lower (upper) bound
+    template<class RandomAccessIterator, class OutputIterator>
+    void searchBatch(RandomAccessIterator first, RandomAccessIterator last, OutputIterator results, bool exact) const;
+    template<class InputIterator>
+    void append(InputIterator first, InputIterator last); // single pass build behind the last elt
+    void linkRun(std::pair<Key, T>* first, std::pair<Key, T>* last, int cap); // moves a sorted run in behind the last elt, towers capped at level @cap
+    template<class Work>
+    static void runParallel(unsigned int threads, Work work); // work(t) for t in [0, threads), the caller runs t = 0; rethrows the first exception
+    static unsigned int threadCount(unsigned int threads, std::size_t work); // @threads (0: hardware threads), at most one per parallelGrain elts of @work
+
+    static_assert(alignof(Node) <= alignof(typename Arena::Line), "node alignment exceeds a cache line");
+
+    static constexpr int batchGroupSize = 8; // searches interleaved by the batched lookups
+    static constexpr std::size_t parallelGrain = 16384; // fewer elts per thread cost more in thread starts than they save
+
+    Arena arena; // node memory
+    const int maxHeight; // max num of levels ("height")
+    int currentHeight = 0; // current "height" of skip-list
+    size_type length = 0; // number of elts
+    unsigned long generation = 0; // bumped whenever nodes get freed, fingers from an older generation are stale
+    Node* head; // head of skiplist
+    Node* tail; // tail of skiplist
+
+    Levels levels; // rolls the node heights
+#if defined(SKIPLIST_STATS)
+    struct Counters { std::uint64_t searches = 0, steps = 0, comparisons = 0, hints = 0, hintMisses = 0; };
+    mutable Counters counters; // bumped by the searches (const ones included)
+#endif
+};
+
+/** implementation **/
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+SkipList<Key, T, Compare, Allocator, Levels>::SkipList(unsigned int maxHeight, const Allocator& allocator) : arena(allocator), maxHeight(std::min<unsigned int>(std::max<unsigned int>(maxHeight, 1), Arena::maxClasses)) // initialises a skiplist with the specified level height
 {
-    return emplace(key, value);
+    init();
 }
 
-// alias for emplace_hint(w/key, value)
-template<typename Key, typename T, class Compare>
-typename SkipList<Key, T, Compare>::iterator SkipList<Key, T, Compare>::insert(const typename SkipList<Key, T, Compare>::iterator position, const Key key, const T value) // inserts a new node
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+template<class InputIterator>
+SkipList<Key, T, Compare, Allocator, Levels>::SkipList(InputIterator first, InputIterator last, unsigned int maxHeight, const Allocator& allocator) : SkipList(maxHeight, allocator) // initialises a skiplist with the elts from [first, last), sorted input is linked in one linear pass
 {
-    return emplace_hint(position, key, value);
+    append(first, last);
 }
 
-// alias for emplace_hint(w/pair)
-template<typename Key, typename T, class Compare>
-typename SkipList<Key, T, Compare>::iterator SkipList<Key, T, Compare>::insert(const typename SkipList<Key, T, Compare>::iterator position, const std::pair<Key, T> pair) // inserts a new node
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+SkipList<Key, T, Compare, Allocator, Levels>::SkipList(SkipList&& other) : arena(std::move(other.arena)), maxHeight(other.maxHeight), currentHeight(other.currentHeight), length(other.length), head(other.head), tail(other.tail), levels(other.levels) // steals the nodes (and the arena) of @other
 {
-    return emplace_hint(position, pair);
+    // leave @other empty (its arena starts over)
+    other.init();
+    other.currentHeight = 0;
+    other.length = 0;
+    other.generation++;
 }
 
-template<typename Key, typename T, class Compare>
-template<class InputIterator>
-void SkipList<Key, T, Compare>::insert(InputIterator first, InputIterator last) // range insert
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+void SkipList<Key, T, Compare, Allocator, Levels>::init()
 {
-    while(first != last)
+    // init space for head and tail
+    head = createSentinel();
+    try
+    {
+        tail = createSentinel();
+    }
+    catch (...)
     {
-        insert(*first);
-        first++;
+        destroySentinel(head);
+        throw;
     }
+
+    linkSentinels();
 }
 
-template<typename Key, typename T, class Compare>
-typename SkipList<Key, T, Compare>::iterator SkipList<Key, T, Compare>::emplace_hint(const typename SkipList<Key, T, Compare>::iterator position, const Key key, const T value) // inserts a new element in the SkipList, with a hint on the insertion position
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+void SkipList<Key, T, Compare, Allocator, Levels>::linkSentinels()
 {
-    SkipList<Key, T, Compare>::iterator pos = position;
-    pos--; // so the perfect position is now just before the insertion point
-    // is the given position invalid ?
-    if (Compare()(pos.it->pair.first, key) || pos == end() || pos.it == head)
-        return emplace(key, value); // --> then we ignore the hint entirely
-
-    std::uniform_real_distribution<double> distribution(0.0, 1.0);
-    double p = distribution(generator); // [0, 1)
-
-    /*
-     * calculates the node's top level using a dice roll
-     * lvl = -log_2(p)
-    */
-    int lvl;
-    std::frexp(p, &lvl);
-    lvl = -lvl;
-
-    if (lvl >= maxHeight)
-        lvl = maxHeight - 1;
-    if (lvl >= currentHeight)
-        currentHeight = lvl + 1;
-
-    // insertion
-    Node* newNode = new Node(key, value, lvl); // creation
-    Node* it = pos.it; // our node iterator
-    // iterate over levels, from pos.height to bottom
-    for (int i = it->height - 1; i >= 0; i--)
+    // init head and tail pointers
+    for (int i = 0; i != maxHeight; i++)
     {
-        // iterate through the current level, from left to right
-        for (it; it->next[i] != tail; it = it->next[i])
-        {
-            if(Compare()(it->next[i]->pair.first, key))
-                break;
-        }
-
-        // rebind the pointers ?
-        if (i <= lvl)
+        setNext(head, i, tail);
+        tail->next()[i] = NULL;
+        if (backLinks || i == 0)
         {
-            newNode->next[i] = it->next[i];
-            it->next[i] = newNode;
-
-            newNode->prev[i] = it;
-            newNode->next[i]->prev[i] = newNode;
+            head->prev()[i] = NULL;
+            tail->prev()[i] = head;
         }
+        head->width()[i] = 1;
+        tail->width()[i] = 0;
     }
+}
 
-    // iterate over levels, from pos.height to currentLevelCount (up)
-    int i = pos.it->height - 1; // we've built to that lvl at max
-    if (i < lvl)
-        it = newNode->prev[i]; // last node at least as high as @pos
-    while(i < lvl)
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+SkipList<Key, T, Compare, Allocator, Levels>::~SkipList()
+{
+    destroyNodes(); // the arena drops the memory chunk by chunk
+    destroySentinel(head);
+    destroySentinel(tail);
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+void SkipList<Key, T, Compare, Allocator, Levels>::destroyNodes()
+{
+    // only walk the nodes if they have something to destroy
+    if (!std::is_trivially_destructible<Node>::value)
     {
-        // iterate through the current level, from right to left
-        while(true)
+        Node* it = head->next()[0];
+        Node* next;
+        while (it != tail)
         {
-            // higher node ? --> rebind pointers
-            if (it->height - 1 > i)
-            {
-                i++;
-                newNode->next[i] = it->next[i];
-                it->next[i] = newNode;
-
-                newNode->prev[i] = it;
-                newNode->next[i]->prev[i] = newNode;
-                break;
-            }
-            it = it->prev[i]; // move left
+            next = it->next()[0];
+            it->~Node();
+            it = next;
         }
     }
+}
 
-    return newNode;
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+typename SkipList<Key, T, Compare, Allocator, Levels>::Node* SkipList<Key, T, Compare, Allocator, Levels>::createSentinel() // allocates a node with a default constructed pair; a list without elts of its own never touches its arena
+{
+    std::size_t lines = Arena::lines(maxHeight - 1);
+    typename Arena::Line* block = std::allocator_traits<typename Arena::LineAllocator>::allocate(arena.allocator, lines);
+    try
+    {
+        return new (block) Node(maxHeight - 1);
+    }
+    catch (...)
+    {
+        std::allocator_traits<typename Arena::LineAllocator>::deallocate(arena.allocator, block, lines);
+        throw;
+    }
 }
 
-template<typename Key, typename T, class Compare>
-typename SkipList<Key, T, Compare>::iterator SkipList<Key, T, Compare>::emplace_hint(const typename SkipList<Key, T, Compare>::iterator position, const std::pair<Key, T> pair) // inserts a new element in the SkipList, with a hint on the insertion position
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+void SkipList<Key, T, Compare, Allocator, Levels>::destroySentinel(Node* node)
 {
-    return emplace_hint(position, pair.first, pair.second);
+    std::size_t lines = Arena::lines(maxHeight - 1);
+    node->~Node();
+    std::allocator_traits<typename Arena::LineAllocator>::deallocate(arena.allocator, reinterpret_cast<typename Arena::Line*>(node), lines);
 }
 
-template<typename Key, typename T, class Compare>
-typename SkipList<Key, T, Compare>::iterator SkipList<Key, T, Compare>::find(const Key key) // searches the container for an element with a key equivalent to k and returns an iterator to it if found, otherwise it returns an iterator to SkipList::end.
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+template<class... Args>
+typename SkipList<Key, T, Compare, Allocator, Levels>::Node* SkipList<Key, T, Compare, Allocator, Levels>::createNode(int level, Args&&... args) // allocates a node, its pair and its tower in one go
 {
-    Node* it = head; // our node iterator
-    // iterate over levels, from top to bottom
-    for (int i = currentHeight - 1; i >= 0; i--)
+    void* block = arena.allocate(level, Node::blockSize(level));
+    try
     {
-        // iterate throught the current level, from left to right
-        for (it; it->next[i] != tail; it = it->next[i])
-        {
-            if(Compare()(it->next[i]->pair.first, key))
-                break;
-            // found ?
-            if (!Compare()(it->next[i]->pair.first, key) && !Compare()(key, it->next[i]->pair.first)) // same as: it->next[i]->pair.first == key
-            {
-                it = it->next[i];
-                // move to the first elt. with this key (move towards left)
-                for (; (!Compare()(it->pair.first, key) && !Compare()(key, it->pair.first)); it = it->prev[0]);
-                return it->next[0]; // found node (iterator)
-            }
-        }
+        return new (block) Node(level, std::forward<Args>(args)...);
     }
+    catch (...)
+    {
+        arena.deallocate(block, level);
+        throw;
+    }
+}
 
-    return tail; // end
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+void SkipList<Key, T, Compare, Allocator, Levels>::destroyNode(Node* node)
+{
+    int level = node->height - 1;
+    node->~Node();
+    arena.deallocate(node, level);
 }
 
-template<typename Key, typename T, class Compare>
-typename SkipList<Key, T, Compare>::iterator SkipList<Key, T, Compare>::lower_bound(const Key key) const // returns an iterator pointing to the first element in the container whose key is not considered to go before k (i.e., either it is equivalent or goes after)
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+int SkipList<Key, T, Compare, Allocator, Levels>::randomLevel() // rolls the level of a new node, grows the list height if the node is higher than all the others
 {
-    Node* it = head; // our node iterator
-    // iterate over levels, from top to bottom
-    for (int i = currentHeight - 1; i >= 0; i--)
-    {
-        // iterate throught the current level, from left to right
-        for (it; it->next[i] != tail; it = it->next[i])
-        {
-            if(Compare()(it->next[i]->pair.first, key))
-                break;
-            // found ?
-            if (!Compare()(it->next[i]->pair.first, key) && !Compare()(key, it->next[i]->pair.first)) // same as: it->next[i]->pair.first == key
-            {
-                it = it->next[i];
-                // move to the first elt. with this key (move towards left)
-                for (; (!Compare()(it->pair.first, key) && !Compare()(key, it->pair.first)); it = it->prev[0]);
-                return it->next[0]; // found node (iterator)
-            }
-        }
-    }
+    int lvl = cappedLevel(levels, length, maxHeight);
+    growHeight(lvl);
 
-    return it->next[0]; // next
+    return lvl;
 }
 
-template<typename Key, typename T, class Compare>
-typename SkipList<Key, T, Compare>::iterator SkipList<Key, T, Compare>::upper_bound(const Key key) const // returns an iterator pointing to the first element in the container whose key is not considered to go before k (i.e., either it is equivalent or goes after)
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+void SkipList<Key, T, Compare, Allocator, Levels>::growHeight(int level)
 {
-    Node* it = head; // our node iterator
-    // iterate over levels, from top to bottom
-    for (int i = currentHeight - 1; i >= 0; i--)
+    for (; currentHeight <= level; currentHeight++)
+        head->width()[currentHeight] = length + 1; // a fresh level is a single link, from head to tail
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+void SkipList<Key, T, Compare, Allocator, Levels>::setNext(Node* node, int level, Node* next) const
+{
+    node->next()[level] = next;
+    if constexpr (cachedKeys)
+        node->nextKeys()[level] = next == tail ? KeySearch::sentinel() : next->pair.first;
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+void SkipList<Key, T, Compare, Allocator, Levels>::link(Node* newNode, Node* const* update, const size_type* rank) // update[i] is the node in front of the insertion point on level i, rank[i] its rank
+{
+    size_type newRank = rank[0] + 1;
+
+    // rebind the pointers
+    for (int i = 0; i != newNode->height; i++)
     {
-        // iterate throught the current level, from left to right
-        for (it; it->next[i] != tail; it = it->next[i])
+        Node* left = update[i];
+        setNext(newNode, i, left->next()[i]);
+        setNext(left, i, newNode);
+
+        if (backLinks || i == 0)
         {
-            if(Compare()(it->next[i]->pair.first, key))
-                break;
+            newNode->prev()[i] = left;
+            newNode->next()[i]->prev()[i] = newNode;
         }
+
+        // split the width of the link we got inserted into
+        newNode->width()[i] = left->width()[i] - (newRank - rank[i]) + 1;
+        left->width()[i] = newRank - rank[i];
     }
 
-    return it->next[0]; // next
+    // the links jumping over the new node got one elt longer
+    for (int i = newNode->height; i < currentHeight; i++)
+        update[i]->width()[i]++;
+
+    length++;
 }
 
-template<typename Key, typename T, class Compare>
-typename SkipList<Key, T, Compare>::iterator SkipList<Key, T, Compare>::erase(const typename SkipList<Key, T, Compare>::iterator it) // removes the node from the container, return the next node (@level 0)
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+void SkipList<Key, T, Compare, Allocator, Levels>::unlink(Node* node)
 {
-    // we don't want to bite off our head or tail :)
-    if (it.it != head && it.it != tail)
+    if constexpr (!backLinks)
     {
-        // rebind pointers
-        for (int i = 0; i != it.it->height; i++)
+        // no way back on the upper levels --> search for the node in front of @node on every level
+        Node* update[Arena::maxClasses];
+        size_type rank[Arena::maxClasses];
+        pathTo(node->prev()[0], update, rank);
+
+        for (int i = 0; i != node->height; i++)
         {
-            it.it->prev[i]->next[i] = it.it->next[i];
-            it.it->next[i]->prev[i] = it.it->prev[i];
+            setNext(update[i], i, node->next()[i]);
+            update[i]->width()[i] += node->width()[i] - 1;
         }
+        node->next()[0]->prev()[0] = update[0];
 
-        iterator retIt = it.it->next[0]; // next node in level 0
-        delete it.it;
-        return retIt; // return the next node in level 0
+        // the links jumping over the node got one elt shorter
+        for (int i = node->height; i < currentHeight; i++)
+            update[i]->width()[i]--;
+
+        length--;
+        generation++;
+        return;
     }
-    else
+
+    // rebind pointers
+    for (int i = 0; i != node->height; i++)
     {
-        throw std::out_of_range("argument iterator does not point to a valid node");
+        setNext(node->prev()[i], i, node->next()[i]);
+        node->next()[i]->prev()[i] = node->prev()[i];
+        node->prev()[i]->width()[i] += node->width()[i] - 1;
+    }
+
+    // the links jumping over the node got one elt shorter, find them by climbing to the left
+    Node* left = node->prev()[node->height - 1];
+    for (int i = node->height; i < currentHeight; i++)
+    {
+        while (left->height <= i)
+            left = left->prev()[i - 1];
+        left->width()[i]--;
     }
+
+    length--;
+    generation++;
 }
 
-template<typename Key, typename T, class Compare>
-typename SkipList<Key, T, Compare>::size_type SkipList<Key, T, Compare>::erase(const Key key) // removes all the nodes with Key from the container, returns the number of elts removed
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+template<class... Args>
+typename SkipList<Key, T, Compare, Allocator, Levels>::iterator SkipList<Key, T, Compare, Allocator, Levels>::emplace(Args&&... args) // inserts a new node, behind the elts with an equivalent key
 {
-    Node* it = head; // our node iterator
-    Node* leftOfFound;
-    // iterate over levels, from top to bottom
-    for (int i = currentHeight - 1; i >= 0; i--)
-    {
-        // iterate throught the current level, from left to right
-        for (it; it->next[i] != tail; it = it->next[i])
-        {
-            if(Compare()(it->next[i]->pair.first, key))
-                break;
-            // found first match
-            if (!Compare()(it->next[i]->pair.first, key) && !Compare()(key, it->next[i]->pair.first)) // same as: it->next[i]->pair.first == key
-            {
-                // remove all the elements with @key
-                it = it->next[i];
-                leftOfFound = it->prev[0];
-                int count = 0;
+    // the node is built first, so the search can use its key (nothing gets copied)
+    int lvl = randomLevel();
+    return insertNode(createNode(lvl, std::forward<Args>(args)...));
+}
 
-                // remove right
-                while(!Compare()(it->pair.first, key) && !Compare()(key, it->pair.first)) // same as: it->pair.first == key
-                {
-                    // rebind pointers
-                    for (int i = 0; i != it->height; i++)
-                    {
-                        it->prev[i]->next[i] = it->next[i];
-                        it->next[i]->prev[i] = it->prev[i];
-                    }
-
-                    Node* nextIt = it->next[0];
-                    delete it;
-                    it = nextIt;
-                    count++;
-                }
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+typename SkipList<Key, T, Compare, Allocator, Levels>::Node* SkipList<Key, T, Compare, Allocator, Levels>::insertNode(Node* newNode)
+{
+    // find the insertion point on every level, remember the rank of the node we left each level from
+    Node* update[Arena::maxClasses];
+    size_type rank[Arena::maxClasses];
+    descend(newNode->pair.first, true, update, rank);
 
-                // remove left
-                it = leftOfFound;
-                while(!Compare()(it->pair.first, key) && !Compare()(key, it->pair.first)) // same as: it->pair.first == key
-                {
-                    // rebind pointers
-                    for (int i = 0; i != it->height; i++)
-                    {
-                        it->prev[i]->next[i] = it->next[i];
-                        it->next[i]->prev[i] = it->prev[i];
-                    }
-
-                    Node* nextIt = it->prev[0];
-                    delete it;
-                    it = nextIt;
-                    count++;
-                }
+    // insertion
+    link(newNode, update, rank);
 
-                return count;
-            }
-        }
-    }
+    return newNode;
+}
+
+// alias for emplace(pair)
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+typename SkipList<Key, T, Compare, Allocator, Levels>::iterator SkipList<Key, T, Compare, Allocator, Levels>::insert(const std::pair<Key, T>& pair) // inserts a new node
+{
+    return emplace(pair);
+}
 
-    return 0; // couldn't remove anything (because key is not in the list)
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+typename SkipList<Key, T, Compare, Allocator, Levels>::iterator SkipList<Key, T, Compare, Allocator, Levels>::insert(std::pair<Key, T>&& pair) // inserts a new node, the pair is moved in
+{
+    return emplace(std::move(pair));
 }
 
-template<typename Key, typename T, class Compare>
-typename SkipList<Key, T, Compare>::iterator SkipList<Key, T, Compare>::begin() const // return start iterator of level 0
+// alias for emplace(key, value)
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+typename SkipList<Key, T, Compare, Allocator, Levels>::iterator SkipList<Key, T, Compare, Allocator, Levels>::insert(const Key& key, const T& value) // inserts a new node
 {
-    return head->next[0];
+    return emplace(key, value);
 }
 
-template<typename Key, typename T, class Compare>
-typename SkipList<Key, T, Compare>::iterator SkipList<Key, T, Compare>::end() const // return past-the-end iterator of level 0
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+typename SkipList<Key, T, Compare, Allocator, Levels>::iterator SkipList<Key, T, Compare, Allocator, Levels>::insert(Key&& key, T&& value) // inserts a new node, key and value are moved in
 {
-    return tail;
+    return emplace(std::move(key), std::move(value));
 }
 
-template<typename Key, typename T, class Compare>
-bool SkipList<Key, T, Compare>::empty() const // returns whether the SkipList container is empty (i.e. whether its size is 0).
+// alias for emplace_hint(w/key, value)
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+typename SkipList<Key, T, Compare, Allocator, Levels>::iterator SkipList<Key, T, Compare, Allocator, Levels>::insert(const typename SkipList<Key, T, Compare, Allocator, Levels>::iterator position, const Key& key, const T& value) // inserts a new node
 {
-     return head->next[0] == tail;
+    return emplace_hint(position, key, value);
 }
 
-template<typename Key, typename T, class Compare>
-void SkipList<Key, T, Compare>::debug() const // print debug list
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+typename SkipList<Key, T, Compare, Allocator, Levels>::iterator SkipList<Key, T, Compare, Allocator, Levels>::insert(const typename SkipList<Key, T, Compare, Allocator, Levels>::iterator position, Key&& key, T&& value) // inserts a new node
 {
-    cout << "debug print START..." << endl;
+    return emplace_hint(position, std::move(key), std::move(value));
+}
 
-    for (Node* it = head->next[0]; it != tail; it = it->next[0])
-    {
-        cout << "node {" << it->pair.first << " , " << it->pair.second << "}" << endl;
-        cout << "height: " << it->height << endl;
+// alias for emplace_hint(w/pair)
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+typename SkipList<Key, T, Compare, Allocator, Levels>::iterator SkipList<Key, T, Compare, Allocator, Levels>::insert(const typename SkipList<Key, T, Compare, Allocator, Levels>::iterator position, const std::pair<Key, T>& pair) // inserts a new node
+{
+    return emplace_hint(position, pair);
+}
 
-        cout << "prev-ptrs: " << endl;
-        for (int i = 0; i != it->height; i++)
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+typename SkipList<Key, T, Compare, Allocator, Levels>::iterator SkipList<Key, T, Compare, Allocator, Levels>::insert(const typename SkipList<Key, T, Compare, Allocator, Levels>::iterator position, std::pair<Key, T>&& pair) // inserts a new node
+{
+    return emplace_hint(position, std::move(pair));
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+template<class... Args>
+std::pair<typename SkipList<Key, T, Compare, Allocator, Levels>::iterator, bool> SkipList<Key, T, Compare, Allocator, Levels>::try_emplace(const Key& key, Args&&... args) // inserts (key, T(args...)) unless an elt with an equivalent key exists
+{
+    return tryEmplace(key, std::forward<Args>(args)...);
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+template<class... Args>
+std::pair<typename SkipList<Key, T, Compare, Allocator, Levels>::iterator, bool> SkipList<Key, T, Compare, Allocator, Levels>::try_emplace(Key&& key, Args&&... args) // inserts (key, T(args...)) unless an elt with an equivalent key exists, @key is moved in
+{
+    return tryEmplace(std::move(key), std::forward<Args>(args)...);
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+template<class K, class... Args>
+std::pair<typename SkipList<Key, T, Compare, Allocator, Levels>::iterator, bool> SkipList<Key, T, Compare, Allocator, Levels>::tryEmplace(K&& key, Args&&... args) // returns the first elt with an equivalent key and false, or the new elt and true
+{
+    Node* update[Arena::maxClasses];
+    size_type rank[Arena::maxClasses];
+    Node* it = descend(key, false, update, rank)->next()[0]; // first elt not going before @key
+
+    // found ? --> nothing gets constructed
+    if (it != tail && !Compare()(it->pair.first, key))
+        return std::pair<iterator, bool>(it, false);
+
+    // the list may grow higher, the new levels are entered from head
+    int height = currentHeight;
+    int lvl = randomLevel();
+    for (int i = height; i < currentHeight; i++)
+    {
+        update[i] = head;
+        rank[i] = 0;
+    }
+
+    Node* newNode = createNode(lvl, std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+    link(newNode, update, rank);
+
+    return std::pair<iterator, bool>(newNode, true);
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+template<class InputIterator>
+void SkipList<Key, T, Compare, Allocator, Levels>::insert(InputIterator first, InputIterator last) // range insert, sorted runs behind the current last elt are appended in O(1) per elt
+{
+    append(first, last);
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+template<class InputIterator>
+void SkipList<Key, T, Compare, Allocator, Levels>::assign_sorted(InputIterator first, InputIterator last) // replaces the contents with the elts from [first, last), in O(n) if the range is sorted
+{
+    clear();
+    append(first, last);
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+template<class InputIterator>
+void SkipList<Key, T, Compare, Allocator, Levels>::parallel_build(InputIterator first, InputIterator last, unsigned int threads) // the Allocator must be usable from several threads at once
+{
+    std::vector<std::pair<Key, T> > elts(first, last);
+    threads = threadCount(threads, elts.size());
+    auto before = [](const std::pair<Key, T>& a, const std::pair<Key, T>& b) { return Compare()(b.first, a.first); };
+
+    // sort runs of the input side by side, then merge neighbouring runs in rounds (stable: equal keys keep their order)
+    std::vector<std::size_t> bounds(threads + 1);
+    for (unsigned int t = 0; t <= threads; t++)
+        bounds[t] = elts.size() * t / threads;
+
+    runParallel(threads, [&](unsigned int t) { std::stable_sort(elts.begin() + bounds[t], elts.begin() + bounds[t + 1], before); });
+    for (unsigned int width = 1; width < threads; width *= 2)
+    {
+        unsigned int merges = (threads + 2 * width - 1) / (2 * width);
+        runParallel(merges, [&](unsigned int m) {
+            unsigned int lo = 2 * width * m;
+            unsigned int mid = std::min(lo + width, threads);
+            unsigned int hi = std::min(lo + 2 * width, threads);
+            std::inplace_merge(elts.begin() + bounds[lo], elts.begin() + bounds[mid], elts.begin() + bounds[hi], before);
+        });
+    }
+
+    // every thread links its run into a list of its own (own arena), towers rolled for the final size
+    clear();
+    int cap = levelCap<Levels>(elts.size(), maxHeight);
+    std::uint64_t base = 0; // the part seeds come from our generator, so seed() still makes the layout reproducible
+    for (int i = 0; i != 8; i++)
+        base = (base << 8) ^ static_cast<std::uint64_t>(levels());
+
+    std::vector<SkipList> parts;
+    parts.reserve(threads);
+    for (unsigned int t = 0; t != threads; t++)
+    {
+        parts.emplace_back(maxHeight, get_allocator());
+        parts[t].seed((base + t + 1) * 0x9E3779B97F4A7C15ull);
+    }
+
+    runParallel(threads, [&](unsigned int t) { parts[t].linkRun(elts.data() + bounds[t], elts.data() + bounds[t + 1], cap); });
+
+    // stitch them together, O(log n) per part
+    for (unsigned int t = 0; t != threads; t++)
+        join(parts[t]);
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+void SkipList<Key, T, Compare, Allocator, Levels>::clear() // removes all elts, gives the node memory back to the allocator
+{
+    destroyNodes();
+    arena.release();
+    forgetNodes();
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+void SkipList<Key, T, Compare, Allocator, Levels>::lastNodes(Node** update, size_type* rank) const
+{
+    if constexpr (!backLinks)
+    {
+        rankPath(length, update, rank);
+        return;
+    }
+
+    for (int i = 0; i != maxHeight; i++)
+    {
+        update[i] = tail->prev()[i];
+        // head's width on levels above currentHeight is not maintained, randomLevel() resets it
+        rank[i] = i < currentHeight ? length + 1 - update[i]->width()[i] : 0;
+    }
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+void SkipList<Key, T, Compare, Allocator, Levels>::linkRun(std::pair<Key, T>* first, std::pair<Key, T>* last, int cap)
+{
+    Node* update[Arena::maxClasses];
+    size_type rank[Arena::maxClasses];
+    lastNodes(update, rank);
+
+    for (; first != last; ++first)
+    {
+        int lvl = std::min(levels(), cap);
+        growHeight(lvl);
+        Node* newNode = createNode(lvl, std::move(*first)); // creation
+        link(newNode, update, rank);
+
+        size_type newRank = rank[0] + 1;
+        for (int i = 0; i <= lvl; i++)
+        {
+            update[i] = newNode;
+            rank[i] = newRank;
+        }
+    }
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+template<class Work>
+void SkipList<Key, T, Compare, Allocator, Levels>::runParallel(unsigned int threads, Work work)
+{
+    std::vector<std::exception_ptr> errors(threads);
+    auto guarded = [&](unsigned int t) {
+        try
+        {
+            work(t);
+        }
+        catch (...)
+        {
+            errors[t] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned int t = 1; t < threads; t++)
+        workers.emplace_back(guarded, t);
+    if (threads != 0)
+        guarded(0);
+    for (std::thread& worker : workers)
+        worker.join();
+
+    for (const std::exception_ptr& error : errors)
+    {
+        if (error)
+            std::rethrow_exception(error);
+    }
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+unsigned int SkipList<Key, T, Compare, Allocator, Levels>::threadCount(unsigned int threads, std::size_t work)
+{
+    if (threads == 0)
+        threads = std::max(std::thread::hardware_concurrency(), 1u);
+    return static_cast<unsigned int>(std::max<std::size_t>(std::min<std::size_t>(threads, work / parallelGrain), 1));
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+template<class InputIterator>
+void SkipList<Key, T, Compare, Allocator, Levels>::append(InputIterator first, InputIterator last) // links the elts right behind the last elt, one by one (no search), as long as they come in sorted
+{
+    Node* update[Arena::maxClasses];
+    size_type rank[Arena::maxClasses];
+    bool stale = true; // do update/rank still describe the end of the list ?
+
+    for (; first != last; ++first)
+    {
+        auto&& pair = *first; // moved from, if the iterator hands out rvalues (std::move_iterator)
+
+        // not sorted (goes before the last elt) ? --> regular insertion
+        Node* lastNode = tail->prev()[0];
+        if (lastNode != head && Compare()(lastNode->pair.first, pair.first))
+        {
+            emplace(std::forward<decltype(pair)>(pair));
+            stale = true;
+            continue;
+        }
+
+        if (stale)
+        {
+            lastNodes(update, rank);
+            stale = false;
+        }
+
+        int lvl = randomLevel();
+        Node* newNode = createNode(lvl, std::forward<decltype(pair)>(pair)); // creation
+        link(newNode, update, rank);
+
+        // the new node is the last one on its levels now
+        size_type newRank = rank[0] + 1;
+        for (int i = 0; i <= lvl; i++)
+        {
+            update[i] = newNode;
+            rank[i] = newRank;
+        }
+    }
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+template<class... Args>
+typename SkipList<Key, T, Compare, Allocator, Levels>::iterator SkipList<Key, T, Compare, Allocator, Levels>::emplace_hint(const typename SkipList<Key, T, Compare, Allocator, Levels>::iterator position, Args&&... args) // inserts a new element in the SkipList, with a hint on the insertion position
+{
+    int lvl = randomLevel();
+    Node* newNode = createNode(lvl, std::forward<Args>(args)...); // creation
+    const Key& key = newNode->pair.first;
+
+    SkipList<Key, T, Compare, Allocator, Levels>::iterator pos = position;
+    pos--; // so the perfect position is now just before the insertion point
+    SKIPLIST_COUNT(hints, 1);
+    // is the given position invalid ?
+    if (pos == end() || pos.it == head || Compare()(pos.it->pair.first, key))
+    {
+        SKIPLIST_COUNT(hintMisses, 1);
+        return insertNode(newNode); // --> then we ignore the hint entirely
+    }
+    if constexpr (!backLinks)
+    {
+        SKIPLIST_COUNT(hintMisses, 1);
+        return insertNode(newNode); // the upper levels can't be reached from @pos without prev, a search finds them just as fast
+    }
+
+    return insertNode(pos.it, newNode);
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+typename SkipList<Key, T, Compare, Allocator, Levels>::Node* SkipList<Key, T, Compare, Allocator, Levels>::insertNode(Node* pos, Node* newNode)
+{
+    const Key& key = newNode->pair.first;
+
+    // ranks are relative to @pos from here on
+    Node* update[Arena::maxClasses];
+    size_type rank[Arena::maxClasses];
+    Node* it = pos; // our node iterator
+    size_type itRank = 0;
+    int top = it->height - 1;
+    // iterate over levels, from pos.height to bottom
+    for (int i = top; i >= 0; i--)
+    {
+        // iterate through the current level, from left to right
+        for (; it->next()[i] != tail; it = it->next()[i])
+        {
+            if(Compare()(it->next()[i]->pair.first, key))
+                break;
+            itRank += it->width()[i];
+        }
+
+        update[i] = it;
+        rank[i] = itRank;
+    }
+
+    // iterate over levels, from pos.height to currentHeight (up)
+    it = update[top]; // last node at least as high as @pos
+    itRank = rank[top];
+    for (int i = top + 1; i < currentHeight; i++)
+    {
+        // iterate through the level below, from right to left, until we hit a node that is high enough
+        while (it->height <= i)
+        {
+            it = it->prev()[i - 1]; // move left
+            itRank -= it->width()[i - 1];
+        }
+
+        update[i] = it;
+        rank[i] = itRank;
+    }
+
+    // insertion
+    link(newNode, update, rank);
+
+    return newNode;
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+typename SkipList<Key, T, Compare, Allocator, Levels>::iterator SkipList<Key, T, Compare, Allocator, Levels>::find(const Key& key) // searches the container for an element with a key equivalent to k and returns an iterator to it if found, otherwise it returns an iterator to SkipList::end.
+{
+    return findNode(key);
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+typename SkipList<Key, T, Compare, Allocator, Levels>::iterator SkipList<Key, T, Compare, Allocator, Levels>::lower_bound(const Key& key) const // returns an iterator pointing to the first element in the container whose key is not considered to go before k (i.e., either it is equivalent or goes after)
+{
+    return descend(key, false, NULL, NULL)->next()[0]; // next
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+typename SkipList<Key, T, Compare, Allocator, Levels>::iterator SkipList<Key, T, Compare, Allocator, Levels>::upper_bound(const Key& key) const // returns an iterator pointing to the first element in the container whose key is not considered to go before k (i.e., either it is equivalent or goes after)
+{
+    return descend(key, true, NULL, NULL)->next()[0]; // next
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+std::pair<typename SkipList<Key, T, Compare, Allocator, Levels>::iterator, typename SkipList<Key, T, Compare, Allocator, Levels>::iterator> SkipList<Key, T, Compare, Allocator, Levels>::equal_range(const Key& key) const // returns the range of elts with a key equivalent to @key
+{
+    return std::pair<iterator, iterator>(lower_bound(key), upper_bound(key));
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+typename SkipList<Key, T, Compare, Allocator, Levels>::size_type SkipList<Key, T, Compare, Allocator, Levels>::count(const Key& key) const // returns the number of elts with a key equivalent to @key, O(log n) thanks to the link widths
+{
+    return countBefore(key, true) - countBefore(key, false);
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+template<class K, class C, class>
+typename SkipList<Key, T, Compare, Allocator, Levels>::iterator SkipList<Key, T, Compare, Allocator, Levels>::find(const K& key) // find(key) for any key type the (transparent) Compare accepts
+{
+    return findNode(key);
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+template<class K, class C, class>
+typename SkipList<Key, T, Compare, Allocator, Levels>::iterator SkipList<Key, T, Compare, Allocator, Levels>::lower_bound(const K& key) const
+{
+    return descend(key, false, NULL, NULL)->next()[0];
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+template<class K, class C, class>
+typename SkipList<Key, T, Compare, Allocator, Levels>::iterator SkipList<Key, T, Compare, Allocator, Levels>::upper_bound(const K& key) const
+{
+    return descend(key, true, NULL, NULL)->next()[0];
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+template<class K, class C, class>
+std::pair<typename SkipList<Key, T, Compare, Allocator, Levels>::iterator, typename SkipList<Key, T, Compare, Allocator, Levels>::iterator> SkipList<Key, T, Compare, Allocator, Levels>::equal_range(const K& key) const
+{
+    return std::pair<iterator, iterator>(lower_bound(key), upper_bound(key));
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+template<class K, class C, class>
+typename SkipList<Key, T, Compare, Allocator, Levels>::size_type SkipList<Key, T, Compare, Allocator, Levels>::count(const K& key) const
+{
+    return countBefore(key, true) - countBefore(key, false);
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+template<class K>
+typename SkipList<Key, T, Compare, Allocator, Levels>::Node* SkipList<Key, T, Compare, Allocator, Levels>::findNode(const K& key) const
+{
+    Node* it = descend(key, false, NULL, NULL)->next()[0]; // first elt. not going before @key
+    if (it == tail || Compare()(it->pair.first, key))
+        return tail; // end
+    return it; // found node (iterator)
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+template<class RandomAccessIterator, class OutputIterator>
+void SkipList<Key, T, Compare, Allocator, Levels>::find_batch(RandomAccessIterator first, RandomAccessIterator last, OutputIterator results) const // writes find(key) for every key in [first, last) to @results
+{
+    searchBatch(first, last, results, true);
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+template<class RandomAccessIterator, class OutputIterator>
+void SkipList<Key, T, Compare, Allocator, Levels>::lower_bound_batch(RandomAccessIterator first, RandomAccessIterator last, OutputIterator results) const // writes lower_bound(key) for every key in [first, last) to @results
+{
+    searchBatch(first, last, results, false);
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+template<class RandomAccessIterator, class OutputIterator>
+void SkipList<Key, T, Compare, Allocator, Levels>::searchBatch(RandomAccessIterator first, RandomAccessIterator last, OutputIterator results, bool exact) const
+{
+    // turns the node in front of the lower bound into the result
+    auto result = [&](Node* it, const Key& key) -> iterator
+    {
+        Node* found = it->next()[0];
+        if (exact && (found == tail || Compare()(found->pair.first, key)))
+            return tail;
+        return found;
+    };
+
+    int height = std::max(currentHeight, 1); // level 0 is always there, even in an empty list
+
+    /*
+     * sorted keys: every search starts from the path of the previous one (finger search),
+     * climb while the old path still ends before the key, then go down as usual
+    */
+    if (std::is_sorted(first, last, [](const Key& a, const Key& b) { return Compare()(b, a); }))
+    {
+        Node* update[Arena::maxClasses];
+        for (int i = 0; i != height; i++)
+            update[i] = head;
+
+        for (; first != last; ++first)
+        {
+            const Key& key = *first;
+            int top = 0;
+            while (top < height - 1 && update[top]->next()[top] != tail && Compare()(key, update[top]->next()[top]->pair.first))
+                top++;
+
+            Node* it = update[top]; // our node iterator
+            // iterate over levels, from top to bottom
+            for (int i = top; i >= 0; i--)
+            {
+                // iterate throught the current level, from left to right, while the next key goes before @key
+                for (; it->next()[i] != tail && Compare()(key, it->next()[i]->pair.first); it = it->next()[i])
+                    SKIPLIST_PREFETCH(it->next()[i]->next()[i]);
+                update[i] = it;
+            }
+
+            *results++ = result(it, key);
+        }
+
+        return;
+    }
+
+    /*
+     * unsorted keys: the searches of a group advance one step at a time, round robin,
+     * so the node one search needs next gets prefetched while the others are working
+    */
+    struct Search
+    {
+        Node* it;
+        int level;
+    };
+
+    while (first != last)
+    {
+        Search searches[batchGroupSize];
+        int count = 0;
+        for (; count != batchGroupSize && first + count != last; count++)
+            searches[count] = Search{ head, height - 1 };
+
+        for (int active = count; active != 0; )
+        {
+            for (int j = 0; j != count; j++)
+            {
+                Search& search = searches[j];
+                if (search.level < 0)
+                    continue; // done
+
+                Node* next = search.it->next()[search.level];
+                if (next != tail && Compare()(first[j], next->pair.first)) // next key goes before the key --> move right
+                {
+                    search.it = next;
+                }
+                else if (--search.level < 0) // --> else move down
+                {
+                    active--;
+                    continue;
+                }
+
+                SKIPLIST_PREFETCH(search.it->next()[search.level]);
+            }
+        }
+
+        for (int j = 0; j != count; j++)
+            *results++ = result(searches[j].it, first[j]);
+        first += count;
+    }
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+typename SkipList<Key, T, Compare, Allocator, Levels>::iterator SkipList<Key, T, Compare, Allocator, Levels>::erase(const typename SkipList<Key, T, Compare, Allocator, Levels>::iterator it) // removes the node from the container, return the next node (@level 0)
+{
+    // we don't want to bite off our head or tail :)
+    if (it.it != head && it.it != tail)
+    {
+        unlink(it.it);
+
+        iterator retIt = it.it->next()[0]; // next node in level 0
+        destroyNode(it.it);
+        return retIt; // return the next node in level 0
+    }
+    else
+    {
+        throw std::out_of_range("argument iterator does not point to a valid node");
+    }
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+typename SkipList<Key, T, Compare, Allocator, Levels>::size_type SkipList<Key, T, Compare, Allocator, Levels>::erase(const Key& key) // removes all the nodes with Key from the container, returns the number of elts removed
+{
+    return eraseKey(key);
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+template<class K, class C, class>
+typename SkipList<Key, T, Compare, Allocator, Levels>::size_type SkipList<Key, T, Compare, Allocator, Levels>::erase(const K& key) // erase(key) for any key type the (transparent) Compare accepts
+{
+    return eraseKey(key);
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+template<class K>
+typename SkipList<Key, T, Compare, Allocator, Levels>::size_type SkipList<Key, T, Compare, Allocator, Levels>::eraseKey(const K& key)
+{
+    if (currentHeight == 0)
+        return 0;
+
+    // splice the run of equal keys out between the paths to its two ends (see erase_range())
+    Node* left[Arena::maxClasses];
+    size_type leftRank[Arena::maxClasses];
+    Node* right[Arena::maxClasses];
+    size_type rightRank[Arena::maxClasses];
+    descend(key, false, left, leftRank);
+    descend(key, true, right, rightRank);
+
+    size_type count = rightRank[0] - leftRank[0];
+    Node* it = cut(left, leftRank, right, rightRank, NULL);
+    for (size_type i = 0; i != count; i++)
+    {
+        Node* nextIt = it->next()[0];
+        destroyNode(it);
+        it = nextIt;
+    }
+
+    return count;
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+typename SkipList<Key, T, Compare, Allocator, Levels>::iterator SkipList<Key, T, Compare, Allocator, Levels>::erase(const typename SkipList<Key, T, Compare, Allocator, Levels>::iterator first, const typename SkipList<Key, T, Compare, Allocator, Levels>::iterator last) // removes the elts in [first, last), returns @last
+{
+    if (first == last)
+        return last;
+
+    Node* left[Arena::maxClasses];
+    size_type leftRank[Arena::maxClasses];
+    Node* right[Arena::maxClasses];
+    size_type rightRank[Arena::maxClasses];
+    pathTo(first.it->prev()[0], left, leftRank);
+    pathTo(last.it->prev()[0], right, rightRank);
+
+    Node* it = cut(left, leftRank, right, rightRank, NULL);
+    for (size_type count = rightRank[0] - leftRank[0]; count != 0; count--)
+    {
+        Node* nextIt = it->next()[0];
+        destroyNode(it);
+        it = nextIt;
+    }
+
+    return last;
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+typename SkipList<Key, T, Compare, Allocator, Levels>::size_type SkipList<Key, T, Compare, Allocator, Levels>::erase_range(const Key& lo, const Key& hi) // removes the elts with a key in [lo, hi), returns the number of elts removed
+{
+    if (currentHeight == 0 || !Compare()(hi, lo))
+        return 0; // empty range
+
+    Node* left[Arena::maxClasses];
+    size_type leftRank[Arena::maxClasses];
+    Node* right[Arena::maxClasses];
+    size_type rightRank[Arena::maxClasses];
+    descend(lo, false, left, leftRank);
+    descend(hi, false, right, rightRank);
+
+    size_type count = rightRank[0] - leftRank[0];
+    Node* it = cut(left, leftRank, right, rightRank, NULL);
+    for (size_type i = 0; i != count; i++)
+    {
+        Node* nextIt = it->next()[0];
+        destroyNode(it);
+        it = nextIt;
+    }
+
+    return count;
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+std::pair<Key, T>& SkipList<Key, T, Compare, Allocator, Levels>::front() const
+{
+    return head->next()[0]->pair;
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+void SkipList<Key, T, Compare, Allocator, Levels>::pop_front()
+{
+    Node* node = head->next()[0];
+    if (node == tail)
+        return;
+
+    // head is the node in front of the first elt on every level, no need to look for it
+    for (int i = 0; i != node->height; i++)
+    {
+        setNext(head, i, node->next()[i]);
+        if (backLinks || i == 0)
+            node->next()[i]->prev()[i] = head;
+        head->width()[i] = node->width()[i]; // the link to @node was 1 wide
+    }
+
+    for (int i = node->height; i < currentHeight; i++)
+        head->width()[i]--;
+
+    length--;
+    generation++;
+    destroyNode(node);
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+typename SkipList<Key, T, Compare, Allocator, Levels>::size_type SkipList<Key, T, Compare, Allocator, Levels>::pop_front_n(size_type k)
+{
+    if (k <= 0 || length == 0)
+        return 0;
+    if (k == 1)
+    {
+        pop_front();
+        return 1;
+    }
+
+    Node* right[Arena::maxClasses];
+    size_type rightRank[Arena::maxClasses];
+    rankPath(std::min(k, length), right, rightRank);
+    return erasePrefix(right, rightRank);
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+typename SkipList<Key, T, Compare, Allocator, Levels>::size_type SkipList<Key, T, Compare, Allocator, Levels>::erase_until(const Key& key)
+{
+    if (length == 0)
+        return 0;
+
+    Node* right[Arena::maxClasses];
+    size_type rightRank[Arena::maxClasses];
+    descend(key, false, right, rightRank);
+    return erasePrefix(right, rightRank);
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+typename SkipList<Key, T, Compare, Allocator, Levels>::size_type SkipList<Key, T, Compare, Allocator, Levels>::erasePrefix(Node* const* right, const size_type* rightRank)
+{
+    // the left path of the cut is head on every level
+    Node* left[Arena::maxClasses];
+    size_type leftRank[Arena::maxClasses];
+    std::fill(left, left + maxHeight, head);
+    std::fill(leftRank, leftRank + maxHeight, 0);
+
+    size_type count = rightRank[0];
+    Node* it = cut(left, leftRank, right, rightRank, NULL);
+    for (size_type i = 0; i != count; i++)
+    {
+        Node* nextIt = it->next()[0];
+        destroyNode(it);
+        it = nextIt;
+    }
+
+    return count;
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+SkipList<Key, T, Compare, Allocator, Levels> SkipList<Key, T, Compare, Allocator, Levels>::extract_range(const Key& lo, const Key& hi) // moves the elts with a key in [lo, hi) into a new list, the nodes are relinked, not copied
+{
+    // the nodes stay where they are, the new list keeps their memory alive
+    SkipList extracted(maxHeight, get_allocator());
+    extracted.arena.adopt(arena);
+    if (currentHeight == 0 || !Compare()(hi, lo))
+        return extracted; // empty range
+
+    Node* left[Arena::maxClasses];
+    size_type leftRank[Arena::maxClasses];
+    Node* right[Arena::maxClasses];
+    size_type rightRank[Arena::maxClasses];
+    descend(lo, false, left, leftRank);
+    descend(hi, false, right, rightRank);
+
+    cut(left, leftRank, right, rightRank, &extracted);
+    return extracted;
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+SkipList<Key, T, Compare, Allocator, Levels> SkipList<Key, T, Compare, Allocator, Levels>::split_at(const Key& key) // moves the elts from lower_bound(key) on into a new list, O(log n)
+{
+    SkipList upper(maxHeight, get_allocator());
+    upper.arena.adopt(arena);
+    if (currentHeight == 0)
+        return upper;
+
+    Node* left[Arena::maxClasses];
+    size_type leftRank[Arena::maxClasses];
+    Node* right[Arena::maxClasses];
+    size_type rightRank[Arena::maxClasses];
+    descend(key, false, left, leftRank);
+    lastNodes(right, rightRank);
+
+    cut(left, leftRank, right, rightRank, &upper);
+    return upper;
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+void SkipList<Key, T, Compare, Allocator, Levels>::join(SkipList& other) // appends the elts of @other behind ours in O(log n), their keys must not go before ours (merge() is used otherwise); leaves @other empty
+{
+    if (&other == this || other.length == 0)
+        return;
+    if (length != 0 && Compare()(tail->prev()[0]->pair.first, other.head->next()[0]->pair.first))
+    {
+        merge(other); // the key ranges overlap
+        return;
+    }
+
+    arena.adopt(other.arena);
+    fitTowers(other);
+
+    Node* update[Arena::maxClasses];
+    size_type rank[Arena::maxClasses];
+    Node* otherLast[Arena::maxClasses];
+    size_type otherRank[Arena::maxClasses];
+    lastNodes(update, rank);
+    other.lastNodes(otherLast, otherRank);
+
+    int height = std::max(currentHeight, other.currentHeight);
+    for (int i = 0; i != height; i++)
+    {
+        if (i >= currentHeight)
+            head->width()[i] = length + 1; // a fresh level is a single link, from head to tail
+
+        Node* left = update[i];
+        Node* first = i < other.currentHeight ? other.head->next()[i] : other.tail;
+        if (first == other.tail)
+        {
+            left->width()[i] += other.length; // nothing of @other on this level, our last link jumps over all of it
+            continue;
+        }
+
+        // hook level i of @other in between our last node and our tail
+        Node* last = otherLast[i];
+        setNext(left, i, first);
+        left->width()[i] = length - rank[i] + other.head->width()[i];
+        setNext(last, i, tail);
+        if (backLinks || i == 0)
+        {
+            first->prev()[i] = left;
+            tail->prev()[i] = last;
+        }
+    }
+
+    currentHeight = height;
+    length += other.length;
+    generation++;
+    other.forgetNodes();
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+void SkipList<Key, T, Compare, Allocator, Levels>::merge(SkipList& other) // moves the elts of @other in (behind our elts with an equal key) in one linear pass over both lists; leaves @other empty
+{
+    if (&other == this || other.length == 0)
+        return;
+
+    arena.adopt(other.arena);
+    fitTowers(other);
+
+    Node* ours = head->next()[0];
+    Node* theirs = other.head->next()[0];
+    forgetNodes();
+
+    // relink the nodes of both lists, in order, behind the last node (see append())
+    Node* update[Arena::maxClasses];
+    size_type rank[Arena::maxClasses];
+    lastNodes(update, rank);
+    while (ours != tail || theirs != other.tail)
+    {
+        Node* node;
+        if (theirs == other.tail || (ours != tail && !Compare()(ours->pair.first, theirs->pair.first)))
+        {
+            node = ours;
+            ours = ours->next()[0];
+        }
+        else
+        {
+            node = theirs;
+            theirs = theirs->next()[0];
+        }
+
+        for (; currentHeight < node->height; currentHeight++)
+            head->width()[currentHeight] = length + 1; // a fresh level is a single link, from head to tail
+        link(node, update, rank);
+
+        // the node is the last one on its levels now
+        size_type newRank = rank[0] + 1;
+        for (int i = 0; i != node->height; i++)
+        {
+            update[i] = node;
+            rank[i] = newRank;
+        }
+    }
+
+    other.forgetNodes();
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+void SkipList<Key, T, Compare, Allocator, Levels>::forgetNodes()
+{
+    linkSentinels();
+    currentHeight = 0;
+    length = 0;
+    generation++;
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+void SkipList<Key, T, Compare, Allocator, Levels>::shrinkTower(Node* node, int height) // the levels that stay move down to the layout of the lower tower
+{
+    Node** oldPrev = node->prev();
+    size_type* oldWidth = node->width();
+    Key* oldKeys = node->nextKeys();
+    std::size_t oldLines = Arena::lines(node->height - 1);
+
+    node->height = height;
+    std::memmove(node->prev(), oldPrev, Node::prevCount(height) * sizeof(Node*));
+    std::memmove(node->width(), oldWidth, height * sizeof(size_type));
+    if constexpr (cachedKeys)
+        std::memmove(node->nextKeys(), oldKeys, height * sizeof(Key));
+
+    // the block has to match the size class of the new height (destroyNode() files it there), the lines behind it are free blocks now
+    std::size_t lines = Arena::lines(height - 1);
+    arena.recycle(reinterpret_cast<typename Arena::Line*>(node) + lines, oldLines - lines, maxHeight);
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+void SkipList<Key, T, Compare, Allocator, Levels>::fitTowers(SkipList& other) // only needed if @other is higher than we can be, its nodes above maxHeight are all on its level maxHeight
+{
+    if (other.currentHeight <= maxHeight)
+        return;
+
+    for (Node* it = other.head->next()[maxHeight]; it != other.tail; )
+    {
+        Node* next = it->next()[maxHeight];
+        shrinkTower(it, maxHeight);
+        it = next;
+    }
+    other.currentHeight = maxHeight;
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+void SkipList<Key, T, Compare, Allocator, Levels>::pathTo(Node* node, Node** update, size_type* rank) const
+{
+    if constexpr (!backLinks)
+    {
+        rankPath(rankOf(node), update, rank);
+        return;
+    }
+
+    Node* it = node;
+    size_type itRank = rankOf(node);
+    // iterate over levels, from bottom to top
+    for (int i = 0; i < currentHeight; i++)
+    {
+        // move left until we hit a node that is high enough
+        while (it->height <= i)
+        {
+            it = it->prev()[i - 1];
+            itRank -= it->width()[i - 1];
+        }
+
+        update[i] = it;
+        rank[i] = itRank;
+    }
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+void SkipList<Key, T, Compare, Allocator, Levels>::rankPath(size_type target, Node** update, size_type* rank) const
+{
+    Node* it = head; // our node iterator
+    size_type itRank = 0;
+    for (int i = maxHeight - 1; i >= currentHeight; i--)
+    {
+        update[i] = head;
+        rank[i] = 0;
+    }
+
+    // iterate over levels, from top to bottom, without overshooting @target
+    for (int i = currentHeight - 1; i >= 0; i--)
+    {
+        for (; it->next()[i] != tail && itRank + it->width()[i] <= target; it = it->next()[i])
+            itRank += it->width()[i];
+
+        update[i] = it;
+        rank[i] = itRank;
+    }
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+typename SkipList<Key, T, Compare, Allocator, Levels>::size_type SkipList<Key, T, Compare, Allocator, Levels>::rankOf(Node* node) const
+{
+    if (node == head)
+        return 0;
+
+    if constexpr (!backLinks)
+    {
+        // search the first elt with the same key, then walk to @node over the equal keys
+        Node* update[Arena::maxClasses];
+        size_type rank[Arena::maxClasses];
+        Node* it = descend(node->pair.first, false, update, rank);
+        size_type itRank = rank[0];
+        for (; it != node; it = it->next()[0])
+            itRank++;
+        return itRank;
+    }
+
+    // walk back to head, always on the highest level of the node we're at
+    size_type rank = 0;
+    while (node != head)
+    {
+        Node* left = node->prev()[node->height - 1];
+        rank += left->width()[node->height - 1];
+        node = left;
+    }
+
+    return rank;
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+template<class Function>
+void SkipList<Key, T, Compare, Allocator, Levels>::parallel_for_each(const Key& lo, const Key& hi, Function fn, unsigned int threads) const
+{
+    size_type first = countBefore(lo);
+    size_type count = countBefore(hi) - first;
+    if (count <= 0)
+        return;
+
+    // the widths tell where every run starts, each thread finds its first node with one rank search
+    threads = threadCount(threads, count);
+    runParallel(threads, [&](unsigned int t) {
+        size_type begin = first + static_cast<size_type>(static_cast<std::int64_t>(count) * t / threads);
+        size_type end = first + static_cast<size_type>(static_cast<std::int64_t>(count) * (t + 1) / threads);
+
+        Node* it = at_rank(begin).it;
+        for (size_type i = begin; i != end; i++, it = it->next()[0])
+            fn(it->pair);
+    });
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+typename SkipList<Key, T, Compare, Allocator, Levels>::Node* SkipList<Key, T, Compare, Allocator, Levels>::cut(Node* const* left, const size_type* leftRank, Node* const* right, const size_type* rightRank, SkipList* into) // left[i]/right[i]: last node on level i in front of / inside the range; links the range into @into (an empty list that adopted our arena) or leaves it dangling for the caller to free, returns its first node
+{
+    size_type count = rightRank[0] - leftRank[0];
+    Node* first = left[0]->next()[0];
+    if (count <= 0)
+        return first;
+
+    for (int i = 0; i < currentHeight; i++)
+    {
+        // none of the range reaches this level --> the link over it just got shorter
+        if (left[i] == right[i])
+        {
+            left[i]->width()[i] -= count;
+            continue;
+        }
+
+        Node* firstNode = left[i]->next()[i];
+        Node* after = right[i]->next()[i];
+        size_type firstRank = leftRank[i] + left[i]->width()[i];
+        size_type afterRank = rightRank[i] + right[i]->width()[i];
+
+        // bridge the gap
+        setNext(left[i], i, after);
+        if (backLinks || i == 0)
+            after->prev()[i] = left[i];
+        left[i]->width()[i] = afterRank - leftRank[i] - count;
+
+        // the range becomes level i of @into, ranks relative to the node in front of it
+        if (into != NULL)
+        {
+            into->setNext(into->head, i, firstNode);
+            into->head->width()[i] = firstRank - leftRank[0];
+            into->setNext(right[i], i, into->tail);
+            if (backLinks || i == 0)
+            {
+                firstNode->prev()[i] = into->head;
+                into->tail->prev()[i] = right[i];
+            }
+            right[i]->width()[i] = count + 1 - (rightRank[i] - leftRank[0]);
+
+            into->currentHeight = i + 1;
+        }
+    }
+
+    length -= count;
+    generation++;
+    if (into != NULL)
+        into->length = count;
+
+    return first;
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+typename SkipList<Key, T, Compare, Allocator, Levels>::Node* SkipList<Key, T, Compare, Allocator, Levels>::fingerSearch(finger& from, const Key& key, bool upper) const
+{
+    // should the search move past @node ?
+    auto before = [&](Node* node)
+    {
+        if (node == head)
+            return true;
+        if (node == tail)
+            return false;
+        SKIPLIST_COUNT(comparisons, 1);
+        return upper ? !Compare()(node->pair.first, key) : Compare()(key, node->pair.first);
+    };
+    SKIPLIST_COUNT(searches, 1);
+
+    // stale finger ? --> start over from head
+    if (from.list != this || from.generation != generation)
+    {
+        from.list = this;
+        from.generation = generation;
+        from.height = 0;
+    }
+    // levels the list grew since the last search
+    for (; from.height < currentHeight; from.height++)
+        from.path[from.height] = head;
+
+    if (currentHeight == 0)
+        return head;
+
+    /*
+     * climb from level 0 while the old path is behind @key (we have to move left)
+     * or while its next node is still in front of @key (a higher level might get us there faster)
+    */
+    int top = 0;
+    while (top < currentHeight - 1 && (!before(from.path[top]) || before(from.path[top]->next()[top])))
+        top++;
+    if (!before(from.path[top]))
+        from.path[top] = head;
+
+    Node* it = from.path[top]; // our node iterator
+    // iterate over levels, from top to bottom
+    for (int i = top; i >= 0; i--)
+    {
+        // iterate throught the current level, from left to right
+        for (; before(it->next()[i]); it = it->next()[i])
+            SKIPLIST_COUNT(steps, 1);
+        from.path[i] = it;
+    }
+
+    return it;
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+typename SkipList<Key, T, Compare, Allocator, Levels>::iterator SkipList<Key, T, Compare, Allocator, Levels>::find(finger& from, const Key& key) const // find(key), starting from the previous search made through @from
+{
+    Node* it = fingerSearch(from, key, false)->next()[0];
+    if (it == tail || Compare()(it->pair.first, key))
+        return tail; // end
+    return it;
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+typename SkipList<Key, T, Compare, Allocator, Levels>::iterator SkipList<Key, T, Compare, Allocator, Levels>::lower_bound(finger& from, const Key& key) const // lower_bound(key), starting from the previous search made through @from
+{
+    return fingerSearch(from, key, false)->next()[0];
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+typename SkipList<Key, T, Compare, Allocator, Levels>::iterator SkipList<Key, T, Compare, Allocator, Levels>::upper_bound(finger& from, const Key& key) const // upper_bound(key), starting from the previous search made through @from
+{
+    return fingerSearch(from, key, true)->next()[0];
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+typename SkipList<Key, T, Compare, Allocator, Levels>::size_type SkipList<Key, T, Compare, Allocator, Levels>::erase(finger& from, const Key& key) // erase(key), starting from the previous search made through @from
+{
+    if constexpr (!backLinks)
+        return erase(key); // unlink() would search for every node anyway, the range splice searches once
+
+    Node* it = fingerSearch(from, key, false)->next()[0];
+    size_type count = 0;
+    while (it != tail && !Compare()(it->pair.first, key)) // it->pair.first == key (nothing in front of it goes before key)
+    {
+        Node* nextIt = it->next()[0];
+        unlink(it);
+        destroyNode(it);
+        it = nextIt;
+        count++;
+    }
+
+    // the removed nodes all come after the path, so it stays valid for @from
+    from.generation = generation;
+    return count;
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+typename SkipList<Key, T, Compare, Allocator, Levels>::iterator SkipList<Key, T, Compare, Allocator, Levels>::begin() const // return start iterator of level 0
+{
+    return head->next()[0];
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+typename SkipList<Key, T, Compare, Allocator, Levels>::iterator SkipList<Key, T, Compare, Allocator, Levels>::end() const // return past-the-end iterator of level 0
+{
+    return tail;
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+bool SkipList<Key, T, Compare, Allocator, Levels>::empty() const // returns whether the SkipList container is empty (i.e. whether its size is 0).
+{
+     return head->next()[0] == tail;
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+typename SkipList<Key, T, Compare, Allocator, Levels>::size_type SkipList<Key, T, Compare, Allocator, Levels>::size() const // returns the number of elements in the SkipList, O(1)
+{
+    return length;
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+typename SkipList<Key, T, Compare, Allocator, Levels>::iterator SkipList<Key, T, Compare, Allocator, Levels>::at_rank(size_type rank) const // returns an iterator to the elt at position @rank (0-based), end() if there is no such elt
+{
+    if (rank < 0 || rank >= length)
+        return tail;
+
+    size_type target = rank + 1; // head is at rank 0
+    size_type itRank = 0;
+    Node* it = head; // our node iterator
+    // iterate over levels, from top to bottom
+    for (int i = currentHeight - 1; i >= 0; i--)
+    {
+        // iterate through the current level, from left to right, without overshooting
+        for (; it->next()[i] != tail && itRank + it->width()[i] <= target; it = it->next()[i])
+            itRank += it->width()[i];
+
+        if (itRank == target)
+            return it;
+    }
+
+    return tail; // not reached
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+typename SkipList<Key, T, Compare, Allocator, Levels>::size_type SkipList<Key, T, Compare, Allocator, Levels>::rank_of(const typename SkipList<Key, T, Compare, Allocator, Levels>::iterator it) const // returns the position (0-based) of the elt @it points to, size() for end()
+{
+    if (it.it == tail)
+        return length;
+
+    return rankOf(it.it) - 1; // head is at rank 0
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+typename SkipList<Key, T, Compare, Allocator, Levels>::size_type SkipList<Key, T, Compare, Allocator, Levels>::count_range(const Key& lo, const Key& hi) const // returns the number of elts with a key in [lo, hi)
+{
+    size_type count = countBefore(hi) - countBefore(lo);
+    return count > 0 ? count : 0;
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+template<class K>
+typename SkipList<Key, T, Compare, Allocator, Levels>::size_type SkipList<Key, T, Compare, Allocator, Levels>::countBefore(const K& key, bool upper) const
+{
+    Node* update[Arena::maxClasses];
+    size_type rank[Arena::maxClasses];
+    descend(key, upper, update, rank);
+    return currentHeight > 0 ? rank[0] : 0;
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+template<class K>
+typename SkipList<Key, T, Compare, Allocator, Levels>::Node* SkipList<Key, T, Compare, Allocator, Levels>::descend(const K& key, bool upper, Node** update, size_type* rank) const // top-down search, fills update[i]/rank[i] (if given) with the node we left level i from, and its rank
+{
+    Node* it = head; // our node iterator
+    size_type itRank = 0;
+    SKIPLIST_COUNT(searches, 1);
+
+    if constexpr (cachedKeys)
+    {
+        /*
+         * the keys of all the next nodes of a tower sit side by side, so a few vector compares find the highest
+         * level we can move right on, the levels above it are done
+        */
+        for (int i = currentHeight - 1; i >= 0; )
+        {
+            int j = KeySearch::highestBefore(it->nextKeys(), i + 1, key, upper);
+            SKIPLIST_COUNT(comparisons, 1);
+            while (j >= 0 && it->next()[j] == tail) // integer sentinels can compare as "before"
+            {
+                j = KeySearch::highestBefore(it->nextKeys(), j, key, upper);
+                SKIPLIST_COUNT(comparisons, 1);
+            }
+
+            // we leave the levels above j from here
+            for (; update != NULL && i > j; i--)
+            {
+                update[i] = it;
+                rank[i] = itRank;
+            }
+            i = j;
+            if (j < 0)
+                break;
+
+            itRank += it->width()[j];
+            it = it->next()[j]; // move right on level j
+            SKIPLIST_COUNT(steps, 1);
+        }
+    }
+    else
+    {
+        // iterate over levels, from top to bottom
+        for (int i = currentHeight - 1; i >= 0; i--)
+        {
+            // iterate throught the current level, from left to right, while the next key goes before @key (or is equivalent to it)
+            for (; it->next()[i] != tail && (upper ? !Compare()(it->next()[i]->pair.first, key) : Compare()(key, it->next()[i]->pair.first)); it = it->next()[i])
+            {
+                itRank += it->width()[i];
+                SKIPLIST_COUNT(steps, 1);
+                SKIPLIST_COUNT(comparisons, 1);
+            }
+            SKIPLIST_COUNT(comparisons, it->next()[i] != tail ? 1 : 0); // the one that stopped us
+
+            if (update != NULL)
+            {
+                update[i] = it;
+                rank[i] = itRank;
+            }
+        }
+    }
+
+    return it;
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+typename SkipList<Key, T, Compare, Allocator, Levels>::allocator_type SkipList<Key, T, Compare, Allocator, Levels>::get_allocator() const // returns a copy of the allocator object associated with the container
+{
+    return allocator_type(arena.allocator);
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+void SkipList<Key, T, Compare, Allocator, Levels>::seed(std::uint64_t value)
+{
+    levels.seed(value);
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+typename SkipList<Key, T, Compare, Allocator, Levels>::statistics SkipList<Key, T, Compare, Allocator, Levels>::stats() const // snapshot of the structure and the counters, walks the upper levels (about n links at p = 1/2)
+{
+    statistics snapshot;
+    snapshot.size = length;
+    snapshot.height = currentHeight;
+
+    // towers of height i + 1 = nodes on level i - nodes on level i + 1
+    size_type onLevel[levelLimit + 1] = { };
+    onLevel[0] = length;
+    for (int i = 1; i < currentHeight; i++)
+        for (Node* it = head->next()[i]; it != tail; it = it->next()[i])
+            onLevel[i]++;
+    for (int i = 0; i < currentHeight; i++)
+        snapshot.levels[i] = onLevel[i] - onLevel[i + 1];
+
+    std::size_t sentinelLines = Arena::lines(maxHeight - 1);
+    snapshot.memory = arena.bytes() + 2 * sentinelLines * sizeof(typename Arena::Line);
+
+#if defined(SKIPLIST_STATS)
+    snapshot.searches = counters.searches;
+    snapshot.steps = counters.steps;
+    snapshot.comparisons = counters.comparisons;
+    snapshot.hints = counters.hints;
+    snapshot.hintMisses = counters.hintMisses;
+#endif
+
+    return snapshot;
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+void SkipList<Key, T, Compare, Allocator, Levels>::save(std::ostream& out, bool heights) const // writes an image of the list: header, tower heights (optional), records in level 0 order
+{
+    static_assert(std::is_trivially_copyable<Key>::value && std::is_trivially_copyable<T>::value, "images hold trivially copyable keys and values only");
+
+    SkipListImageHeader header = SkipListImageHeader::make<Key, T>(length, heights);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    // heights, padded up to the records
+    if (heights)
+    {
+        for (Node* it = head->next()[0]; it != tail; it = it->next()[0])
+            out.put(static_cast<char>(it->height));
+        for (std::uint64_t i = sizeof(header) + length; i != header.recordsOffset; i++)
+            out.put(0);
+    }
+
+    // records, with their in-memory layout (padding zeroed) so FrozenSkipList can use them in place
+    for (Node* it = head->next()[0]; it != tail; it = it->next()[0])
+    {
+        alignas(std::pair<Key, T>) char record[sizeof(std::pair<Key, T>)] = { };
+        new (record) std::pair<Key, T>(it->pair);
+        out.write(record, sizeof(record));
+    }
+
+    if (!out)
+        throw std::runtime_error("SkipList::save: write failed");
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+void SkipList<Key, T, Compare, Allocator, Levels>::load(std::istream& in) // replaces the contents with the elts of an image written by save(), linked behind each other without searching
+{
+    static_assert(std::is_trivially_copyable<Key>::value && std::is_trivially_copyable<T>::value, "images hold trivially copyable keys and values only");
+
+    clear();
+
+    SkipListImageHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)))
+        throw std::runtime_error("SkipList::load: image too small");
+    const char* problem = header.mismatch<Key, T>();
+    if (problem != NULL)
+        throw std::runtime_error(std::string("SkipList::load: ") + problem);
+
+    // heights in chunks: a header announcing more elts than the stream holds fails before we allocate for all of them
+    std::vector<unsigned char> heights;
+    if (header.flags & SkipListImageHeader::towerHeights)
+    {
+        while (heights.size() != header.count)
+        {
+            std::size_t done = heights.size();
+            std::size_t chunk = static_cast<std::size_t>(std::min<std::uint64_t>(header.count - done, 65536));
+            heights.resize(done + chunk);
+            if (!in.read(reinterpret_cast<char*>(heights.data()) + done, chunk))
+                throw std::runtime_error("SkipList::load: image truncated");
+        }
+    }
+    in.ignore(static_cast<std::streamsize>(header.recordsOffset - sizeof(header) - heights.size())); // padding, under 64 bytes (mismatch() bounds the offset)
+    if (!in)
+        throw std::runtime_error("SkipList::load: image truncated");
+
+    // every new elt is the last one on its levels, like in append()
+    Node* update[Arena::maxClasses];
+    size_type rank[Arena::maxClasses];
+    std::fill(update, update + maxHeight, head);
+    std::fill(rank, rank + maxHeight, 0);
+
+    for (std::uint64_t i = 0; i != header.count; i++)
+    {
+        alignas(std::pair<Key, T>) char record[sizeof(std::pair<Key, T>)];
+        if (!in.read(record, sizeof(record)))
+        {
+            clear();
+            throw std::runtime_error("SkipList::load: image truncated");
+        }
+        const std::pair<Key, T>& pair = *reinterpret_cast<const std::pair<Key, T>*>(record);
+
+        Node* lastNode = tail->prev()[0];
+        if (lastNode != head && Compare()(lastNode->pair.first, pair.first))
+        {
+            clear();
+            throw std::runtime_error("SkipList::load: records out of order");
+        }
+
+        int lvl;
+        if (heights.empty())
+        {
+            lvl = randomLevel();
+        }
+        else
+        {
+            lvl = std::min<int>(std::max<int>(heights[i], 1), maxHeight) - 1; // towers of a higher list are cut to our maxHeight
+            growHeight(lvl);
+        }
+        Node* newNode = createNode(lvl, pair); // creation
+        link(newNode, update, rank);
+
+        size_type newRank = rank[0] + 1;
+        for (int j = 0; j <= lvl; j++)
+        {
+            update[j] = newNode;
+            rank[j] = newRank;
+        }
+    }
+}
+
+template<typename Key, typename T, class Compare, class Allocator, class Levels>
+void SkipList<Key, T, Compare, Allocator, Levels>::debug() const // print debug list
+{
+    std::cout << "debug print START..." << std::endl;
+
+    for (Node* it = head->next()[0]; it != tail; it = it->next()[0])
+    {
+        std::cout << "node {" << it->pair.first << " , " << it->pair.second << "}" << std::endl;
+        std::cout << "height: " << it->height << std::endl;
+
+        std::cout << "prev-ptrs: " << std::endl;
+        for (int i = 0; i != Node::prevCount(it->height); i++)
         {
-            cout << "  " << it->prev[i]->pair.first << endl;
+            std::cout << "  " << it->prev()[i]->pair.first << std::endl;
         }
 
 
-        cout << "next-ptrs: " << endl;
+        std::cout << "next-ptrs: " << std::endl;
         for (int i = 0; i != it->height; i++)
         {
-            cout << "  " << it->next[i]->pair.first << endl;
+            std::cout << "  " << it->next()[i]->pair.first << std::endl;
         }
-        cout << "------------------------------------" << endl;
+        std::cout << "------------------------------------" << std::endl;
     }
 
-    cout << "...debug print END" << endl;
+    std::cout << "...debug print END" << std::endl;
 }
 
 #endif // SKIPLIST_H
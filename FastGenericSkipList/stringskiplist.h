@@ -0,0 +1,455 @@
+#ifndef STRINGSKIPLIST_H
+#define STRINGSKIPLIST_H
+
+#include <iterator> // bidirectional_iterator_tag
+#include <utility> // pair, forward
+#include <string> // string
+#include <string_view> // string_view
+#include <cstdint> // uint32_t, uint64_t
+#include <cstddef> // size_t
+#include <cstring> // memcpy
+#include <new> // operator new
+#include <algorithm> // min, max
+#include <stdexcept> // out_of_range, length_error
+
+#include "levelgenerator.h"
+
+
+/*
+ * skip list for string keys (long paths, URLs, ... with large shared prefixes), ordered by bytes like std::string
+ * the key bytes live inline at the end of the node (no separate heap string), and every link carries what a search
+ * needs to decide on it without reading the key it points to:
+ * - lcp: length of the common prefix of the two keys it joins (on level 0 that's the front coding against the
+ *   predecessor)
+ * - chunk: the 8 bytes of the next key right after that prefix (its distinguishing bytes)
+ * a search tracks how many bytes of its key match the node it stands on. a link whose lcp is shorter or longer
+ * than that decides the step by itself; an equal one compares the 8 distinguishing bytes with the key's bytes at
+ * that position; only if those are equal too is the next key read (from there on, never from its first byte).
+*/
+template <typename T, class Levels = GeometricLevels<> > class StringSkipList
+{
+public:
+    struct Node
+    {
+        T value;
+        std::uint32_t length; // key bytes
+        int height; // height of this node
+
+        template<class... Args>
+        Node(int level, std::uint32_t length, Args&&... args) : value(std::forward<Args>(args)...), length(length), height(level + 1) { }
+
+        // one allocation: [ Node | next[0 .. height-1] | prev[0 .. height-1] | chunks[0 .. height-1] | links[0 .. height-1] | key bytes ]
+        Node** next() { return reinterpret_cast<Node**>(reinterpret_cast<char*>(this) + towerOffset()); } // aray of ptrs
+        Node** prev() { return next() + height; } // aray of ptrs
+        std::uint64_t* chunks() { return reinterpret_cast<std::uint64_t*>(prev() + height); } // distinguishing bytes of next[i], big endian
+        std::uint32_t* links() { return reinterpret_cast<std::uint32_t*>(chunks() + height); } // lcp with next[i] << 4 | bytes in chunks[i]
+        char* bytes() { return reinterpret_cast<char*>(links() + height); }
+        std::string_view key() { return std::string_view(bytes(), length); }
+
+        static constexpr std::size_t towerOffset() { return (sizeof(Node) + alignof(std::uint64_t) - 1) / alignof(std::uint64_t) * alignof(std::uint64_t); }
+        static std::size_t blockSize(int level, std::size_t length) { return towerOffset() + (level + 1) * (2 * sizeof(Node*) + sizeof(std::uint64_t) + sizeof(std::uint32_t)) + length; }
+    };
+
+    // iterator implementation, the elts are (key, value reference) pairs
+    class iterator
+    {
+        friend class StringSkipList;
+    private:
+        Node* it;
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef std::pair<std::string_view, T&> value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef value_type reference;
+
+        struct pointer // lets it->first / it->second work on the pair
+        {
+            value_type pair;
+            const value_type* operator->() const { return &pair; }
+        };
+
+        iterator(Node* node = NULL) : it(node) { }
+        iterator operator++(int) { iterator old = *this; it = it->next()[0]; return old; }
+        iterator& operator++() { it = it->next()[0]; return *this; }
+        iterator operator--(int) { iterator old = *this; it = it->prev()[0]; return old; }
+        iterator& operator--() { it = it->prev()[0]; return *this; }
+        bool operator==(const iterator& other) const { return it == other.it; }
+        bool operator!=(const iterator& other) const { return it != other.it; }
+        value_type operator*() const { return value_type(it->key(), it->value); }
+        pointer operator->() const { return pointer{ **this }; }
+    };
+
+    typedef int size_type;
+    static constexpr std::size_t maxKeyLength = (std::size_t(1) << 28) - 1; // lcp and chunk size share 32 bits
+
+    StringSkipList(unsigned int maxLevels = 32);
+    StringSkipList(const StringSkipList&) = delete;
+    StringSkipList& operator=(const StringSkipList&) = delete;
+    ~StringSkipList();
+
+    template<class... Args>
+    iterator emplace(std::string_view key, Args&&... args); // the value is built in place from @args, behind the elts with an equal key
+    iterator insert(const std::pair<std::string, T>& pair);
+
+    iterator find(std::string_view key) const;
+    iterator lower_bound(std::string_view key) const;
+    iterator upper_bound(std::string_view key) const;
+    size_type count(std::string_view key) const;
+    iterator erase(const iterator it);
+    size_type erase(std::string_view key);
+
+    iterator begin() const;
+    iterator end() const;
+    bool empty() const;
+    size_type size() const;
+    void clear();
+    void seed(std::uint64_t value); // reseeds the level generator
+
+private:
+    static constexpr int levelLimit = 64;
+
+    template<class... Args>
+    static Node* createNode(int level, std::string_view key, Args&&... args);
+    static void destroyNode(Node* node);
+    void init(); // sets up head and tail
+    void destroyNodes();
+
+    static std::uint64_t chunk(std::string_view key, std::size_t from); // up to 8 bytes of @key from @from, big endian, zero padded
+    static std::size_t chunkSize(std::string_view key, std::size_t from) { return std::min<std::size_t>(key.size() - from, 8); }
+    static std::size_t commonPrefix(std::string_view a, std::string_view b, std::size_t from); // lcp of @a and @b, knowing they agree up to @from
+    void setLink(Node* node, int level) const; // recomputes the lcp and chunk of node->next()[level]
+    int order(Node* node, int level, std::string_view key, std::size_t& matched, std::uint64_t& keyChunk, std::size_t& chunkAt) const; // sign of key - node->next()[level]
+    Node* descend(std::string_view key, bool upper, Node** update) const; // returns the node in front of the lower (upper) bound
+
+    const int maxHeight; // max num of levels ("height")
+    int currentHeight = 1; // current "height" of skip-list
+    size_type length = 0; // number of elts
+    Node* head; // head of skiplist, its key is empty
+    Node* tail; // tail of skiplist
+
+    Levels levels; // rolls the node heights
+};
+
+/** implementation **/
+
+template<typename T, class Levels>
+StringSkipList<T, Levels>::StringSkipList(unsigned int maxHeight) : maxHeight(std::min<unsigned int>(std::max<unsigned int>(maxHeight, 1), levelLimit)) // initialises a skiplist with the specified level height
+{
+    init();
+}
+
+template<typename T, class Levels>
+StringSkipList<T, Levels>::~StringSkipList()
+{
+    destroyNodes();
+    destroyNode(head);
+    destroyNode(tail);
+}
+
+template<typename T, class Levels>
+void StringSkipList<T, Levels>::init()
+{
+    head = createNode(maxHeight - 1, std::string_view());
+    tail = createNode(maxHeight - 1, std::string_view());
+
+    for (int i = 0; i != maxHeight; i++)
+    {
+        head->next()[i] = tail;
+        head->prev()[i] = NULL;
+        tail->next()[i] = NULL;
+        tail->prev()[i] = head;
+    }
+}
+
+template<typename T, class Levels>
+void StringSkipList<T, Levels>::destroyNodes() // frees the elts, leaves head and tail alone
+{
+    Node* it = head->next()[0];
+    while (it != tail)
+    {
+        Node* next = it->next()[0];
+        destroyNode(it);
+        it = next;
+    }
+}
+
+template<typename T, class Levels>
+template<class... Args>
+typename StringSkipList<T, Levels>::Node* StringSkipList<T, Levels>::createNode(int level, std::string_view key, Args&&... args) // allocates a node, its tower and its key bytes in one go
+{
+    if (key.size() > maxKeyLength)
+        throw std::length_error("StringSkipList: key too long");
+
+    void* block = ::operator new(Node::blockSize(level, key.size()));
+    Node* node;
+    try
+    {
+        node = new (block) Node(level, static_cast<std::uint32_t>(key.size()), std::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+        ::operator delete(block);
+        throw;
+    }
+
+    if (!key.empty())
+        std::memcpy(node->bytes(), key.data(), key.size());
+    return node;
+}
+
+template<typename T, class Levels>
+void StringSkipList<T, Levels>::destroyNode(Node* node)
+{
+    node->~Node();
+    ::operator delete(node);
+}
+
+template<typename T, class Levels>
+std::uint64_t StringSkipList<T, Levels>::chunk(std::string_view key, std::size_t from)
+{
+    std::uint64_t bytes = 0;
+    std::size_t count = chunkSize(key, from);
+    for (std::size_t i = 0; i != count; i++)
+        bytes |= static_cast<std::uint64_t>(static_cast<unsigned char>(key[from + i])) << (56 - 8 * i);
+    return bytes;
+}
+
+template<typename T, class Levels>
+std::size_t StringSkipList<T, Levels>::commonPrefix(std::string_view a, std::string_view b, std::size_t from)
+{
+    std::size_t end = std::min(a.size(), b.size());
+    while (from != end && a[from] == b[from])
+        from++;
+    return from;
+}
+
+template<typename T, class Levels>
+void StringSkipList<T, Levels>::setLink(Node* node, int level) const
+{
+    Node* next = node->next()[level];
+    if (next == tail)
+        return; // never looked at
+
+    std::string_view key = next->key();
+    std::size_t lcp = commonPrefix(node->key(), key, 0);
+    node->chunks()[level] = chunk(key, lcp);
+    node->links()[level] = static_cast<std::uint32_t>(lcp << 4 | chunkSize(key, lcp));
+}
+
+template<typename T, class Levels>
+int StringSkipList<T, Levels>::order(Node* node, int level, std::string_view key, std::size_t& matched, std::uint64_t& keyChunk, std::size_t& chunkAt) const // @matched: lcp of @key and @node, becomes the one with the next node; keyChunk caches chunk(key, chunkAt)
+{
+    std::size_t lcp = node->links()[level] >> 4;
+
+    // the next key leaves @node's key before (after) we do: ours is smaller (bigger), no byte to look at
+    // (we stand on @node because our key does not go before it, and neither does the next one)
+    if (lcp < matched)
+        return -1;
+    if (lcp > matched)
+        return 1;
+
+    // same branching point: the distinguishing bytes decide, most of the time
+    if (chunkAt != matched)
+    {
+        keyChunk = chunk(key, matched);
+        chunkAt = matched;
+    }
+
+    std::uint64_t nextChunk = node->chunks()[level];
+    std::size_t keySize = chunkSize(key, matched);
+    std::size_t nextSize = node->links()[level] & 15;
+    if (keyChunk != nextChunk)
+    {
+        std::size_t same = levelLeadingZeros(keyChunk ^ nextChunk) / 8;
+        matched += std::min(same, std::min(keySize, nextSize));
+        return keyChunk < nextChunk ? -1 : 1;
+    }
+    if (keySize != nextSize || keySize < 8)
+    {
+        matched += std::min(keySize, nextSize);
+        return keySize < nextSize ? -1 : (keySize > nextSize ? 1 : 0);
+    }
+
+    // 8 equal bytes, read the rest of the next key
+    std::string_view nextKey = node->next()[level]->key();
+    matched = commonPrefix(key, nextKey, matched + 8);
+    if (matched == key.size() || matched == nextKey.size())
+        return key.size() < nextKey.size() ? -1 : (key.size() > nextKey.size() ? 1 : 0);
+    return static_cast<unsigned char>(key[matched]) < static_cast<unsigned char>(nextKey[matched]) ? -1 : 1;
+}
+
+template<typename T, class Levels>
+typename StringSkipList<T, Levels>::Node* StringSkipList<T, Levels>::descend(std::string_view key, bool upper, Node** update) const
+{
+    Node* it = head; // our node iterator
+    std::size_t matched = 0; // lcp of @key and it's key
+    std::uint64_t keyChunk = chunk(key, 0);
+    std::size_t chunkAt = 0;
+
+    // iterate over levels, from top to bottom
+    for (int i = currentHeight - 1; i >= 0; i--)
+    {
+        // iterate through the current level, from left to right, past the keys that go before @key (upper: do not go after it)
+        while (it->next()[i] != tail)
+        {
+            std::size_t common = matched;
+            int sign = order(it, i, key, common, keyChunk, chunkAt);
+            if (sign < 0 || (sign == 0 && !upper))
+                break;
+
+            it = it->next()[i];
+            matched = common;
+        }
+
+        if (update != NULL)
+            update[i] = it;
+    }
+
+    return it;
+}
+
+template<typename T, class Levels>
+template<class... Args>
+typename StringSkipList<T, Levels>::iterator StringSkipList<T, Levels>::emplace(std::string_view key, Args&&... args)
+{
+    Node* update[levelLimit];
+    int lvl = cappedLevel(levels, length, maxHeight);
+    Node* newNode = createNode(lvl, key, std::forward<Args>(args)...); // creation
+    currentHeight = std::max(currentHeight, lvl + 1);
+    descend(newNode->key(), true, update);
+
+    // rebind the pointers, the links in front of the new node and its own ones get their lcp and chunk
+    for (int i = 0; i <= lvl; i++)
+    {
+        Node* left = update[i];
+        newNode->next()[i] = left->next()[i];
+        left->next()[i] = newNode;
+
+        newNode->prev()[i] = left;
+        newNode->next()[i]->prev()[i] = newNode;
+
+        setLink(left, i);
+        setLink(newNode, i);
+    }
+
+    length++;
+    return newNode;
+}
+
+template<typename T, class Levels>
+typename StringSkipList<T, Levels>::iterator StringSkipList<T, Levels>::insert(const std::pair<std::string, T>& pair)
+{
+    return emplace(pair.first, pair.second);
+}
+
+template<typename T, class Levels>
+typename StringSkipList<T, Levels>::iterator StringSkipList<T, Levels>::find(std::string_view key) const // returns an iterator to the first element with @key, end() otherwise
+{
+    Node* it = descend(key, false, NULL)->next()[0];
+    if (it != tail && it->key() == key)
+        return it;
+    return tail;
+}
+
+template<typename T, class Levels>
+typename StringSkipList<T, Levels>::iterator StringSkipList<T, Levels>::lower_bound(std::string_view key) const // first elt whose key does not go before @key
+{
+    return descend(key, false, NULL)->next()[0];
+}
+
+template<typename T, class Levels>
+typename StringSkipList<T, Levels>::iterator StringSkipList<T, Levels>::upper_bound(std::string_view key) const // first elt whose key goes after @key
+{
+    return descend(key, true, NULL)->next()[0];
+}
+
+template<typename T, class Levels>
+typename StringSkipList<T, Levels>::size_type StringSkipList<T, Levels>::count(std::string_view key) const // O(log n + count)
+{
+    size_type count = 0;
+    for (Node* it = descend(key, false, NULL)->next()[0]; it != tail && it->key() == key; it = it->next()[0])
+        count++;
+    return count;
+}
+
+template<typename T, class Levels>
+typename StringSkipList<T, Levels>::iterator StringSkipList<T, Levels>::erase(const iterator it) // removes the node from the container, returns the next node
+{
+    // we don't want to bite off our head or tail :)
+    Node* node = it.it;
+    if (node == head || node == tail)
+        throw std::out_of_range("argument iterator does not point to a valid node");
+
+    // rebind pointers, the links that now jump over the node get the lcp and chunk of their new next key
+    for (int i = 0; i != node->height; i++)
+    {
+        node->prev()[i]->next()[i] = node->next()[i];
+        node->next()[i]->prev()[i] = node->prev()[i];
+        setLink(node->prev()[i], i);
+    }
+
+    Node* next = node->next()[0];
+    destroyNode(node);
+    length--;
+    return next;
+}
+
+template<typename T, class Levels>
+typename StringSkipList<T, Levels>::size_type StringSkipList<T, Levels>::erase(std::string_view key) // removes all the nodes with @key, returns the number of elts removed
+{
+    size_type count = 0;
+    iterator it = lower_bound(key);
+    while (it.it != tail && it.it->key() == key)
+    {
+        it = erase(it);
+        count++;
+    }
+
+    return count;
+}
+
+template<typename T, class Levels>
+typename StringSkipList<T, Levels>::iterator StringSkipList<T, Levels>::begin() const // return start iterator of level 0
+{
+    return head->next()[0];
+}
+
+template<typename T, class Levels>
+typename StringSkipList<T, Levels>::iterator StringSkipList<T, Levels>::end() const // return past-the-end iterator of level 0
+{
+    return tail;
+}
+
+template<typename T, class Levels>
+bool StringSkipList<T, Levels>::empty() const
+{
+    return length == 0;
+}
+
+template<typename T, class Levels>
+typename StringSkipList<T, Levels>::size_type StringSkipList<T, Levels>::size() const
+{
+    return length;
+}
+
+template<typename T, class Levels>
+void StringSkipList<T, Levels>::clear() // removes all elts
+{
+    destroyNodes();
+    for (int i = 0; i != maxHeight; i++)
+    {
+        head->next()[i] = tail;
+        tail->prev()[i] = head;
+    }
+
+    currentHeight = 1;
+    length = 0;
+}
+
+template<typename T, class Levels>
+void StringSkipList<T, Levels>::seed(std::uint64_t value)
+{
+    levels.seed(value);
+}
+
+#endif // STRINGSKIPLIST_H
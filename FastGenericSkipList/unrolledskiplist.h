@@ -0,0 +1,708 @@
+#ifndef UNROLLEDSKIPLIST_H
+#define UNROLLEDSKIPLIST_H
+
+#include <functional> // greater
+#include <iterator> // bidirectional_iterator_tag
+#include <utility> // pair, move, forward, piecewise_construct
+#include <tuple> // forward_as_tuple
+#include <cstdint> // uint64_t
+#include <new> // operator new, align_val_t
+#include <cstddef> // size_t
+#include <algorithm> // min, max, move, move_backward, partition_point
+
+#include "simdkeysearch.h"
+#include "levelgenerator.h"
+
+
+/*
+ * unrolled skip list ("B-skiplist")
+ * level 0 is a list of blocks, each holding up to BlockSize sorted elts in a contiguous array; the upper levels
+ * index the blocks by their first key. scans and in-block searches get array locality, a full block is split in
+ * two, a block that drops below a quarter full is merged with a neighbour.
+ *
+ * same multimap semantics and API as SkipList, but weaker iterator stability:
+ * emplace/insert/emplace_hint invalidate the iterators to the block they insert into (and the one it gets split into),
+ * erase invalidates the iterators to the block it erases from and to the block it gets merged with.
+ * iterators to other blocks stay valid.
+*/
+template <typename Key, typename T, class Compare = std::greater<Key>, int BlockSize = 32, class Levels = GeometricLevels<> > class UnrolledSkipList
+{
+    static_assert(BlockSize >= 4, "blocks need room for at least 4 elts");
+
+public:
+    typedef SimdKeySearch<Key, Compare> KeySearch;
+    static constexpr bool denseKeys = KeySearch::enabled; // blocks mirror their keys in a key-only array, in-block searches use SIMD
+
+    struct Block
+    {
+        int count = 0; // elts in use
+        int height; // height of this block
+
+        Block(int level) : height(level + 1) { }
+
+        // everything lives in one allocation: [ Block | next[0 .. height-1] | prev[0 .. height-1] (| keys[0 .. BlockSize-1]) | elts[0 .. BlockSize-1] ]
+        Block** next() { return reinterpret_cast<Block**>(reinterpret_cast<char*>(this) + towerOffset()); } // aray of ptrs
+        Block** prev() { return next() + height; } // aray of ptrs
+        Key* keys() { return reinterpret_cast<Key*>(reinterpret_cast<char*>(this) + keysOffset(height)); } // copy of the elts' keys, right behind the tower, only there if denseKeys
+        std::pair<Key, T>* elts() { return reinterpret_cast<std::pair<Key, T>*>(reinterpret_cast<char*>(this) + eltsOffset(height)); }
+        const Key& firstKey() { return denseKeys ? keys()[0] : elts()[0].first; }
+
+        static constexpr std::size_t towerOffset() { return (sizeof(Block) + alignof(Block*) - 1) / alignof(Block*) * alignof(Block*); }
+        static std::size_t keysOffset(int height) { return towerOffset() + 2 * height * sizeof(Block*); } // Block* alignment is enough for the arithmetic keys
+        static std::size_t eltsOffset(int height)
+        {
+            std::size_t end = keysOffset(height) + (denseKeys ? BlockSize * sizeof(Key) : 0);
+            return (end + alignof(std::pair<Key, T>) - 1) / alignof(std::pair<Key, T>) * alignof(std::pair<Key, T>);
+        }
+        static std::size_t blockSize(int level) { return eltsOffset(level + 1) + BlockSize * sizeof(std::pair<Key, T>); } // bytes needed for a block of this level
+    };
+
+    // iterator implementation
+    class iterator
+    {
+        friend class UnrolledSkipList;
+    private:
+        Block* block;
+        int index; // position inside the block
+    public:
+        iterator(Block* block = NULL, int index = 0) : block(block), index(index) { }
+        iterator operator++(int) { iterator old = *this; ++*this; return old; }
+        iterator& operator++()
+        {
+            if (++index == block->count)
+            {
+                block = block->next()[0];
+                index = 0;
+            }
+            return *this;
+        }
+        iterator operator--(int) { iterator old = *this; --*this; return old; }
+        iterator& operator--()
+        {
+            if (index-- == 0)
+            {
+                block = block->prev()[0];
+                index = block->count - 1;
+            }
+            return *this;
+        }
+        bool operator==(const iterator& other) const { return block == other.block && index == other.index; }
+        bool operator!=(const iterator& other) const { return !(*this == other); }
+        std::pair<Key, T>& operator*() const { return block->elts()[index]; }
+        std::pair<Key, T>* operator->() const { return &block->elts()[index]; }
+
+        // iterator traits
+        using difference_type = std::ptrdiff_t;
+        using value_type = std::pair<Key, T>;
+        using pointer = std::pair<Key, T>*;
+        using reference = std::pair<Key, T>&;
+        using iterator_category = std::bidirectional_iterator_tag;
+    };
+
+    typedef int size_type;
+
+    UnrolledSkipList(unsigned int maxLevels = 32);
+    UnrolledSkipList(const UnrolledSkipList&) = delete;
+    UnrolledSkipList& operator=(const UnrolledSkipList&) = delete;
+    ~UnrolledSkipList();
+
+    template<class... Args>
+    iterator emplace(Args&&... args); // the elt is built from @args once, then moved into its block
+    iterator insert(const std::pair<Key, T>& pair);
+    iterator insert(std::pair<Key, T>&& pair);
+    iterator insert(const Key& key, const T& value);
+    iterator insert(Key&& key, T&& value);
+    iterator insert(const iterator position, const Key& key, const T& value);
+    iterator insert(const iterator position, Key&& key, T&& value);
+    iterator insert(const iterator position, const std::pair<Key, T>& pair);
+    iterator insert(const iterator position, std::pair<Key, T>&& pair);
+    template<class... Args>
+    std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args); // inserts only if no elt has an equivalent key
+    template<class... Args>
+    std::pair<iterator, bool> try_emplace(Key&& key, Args&&... args);
+
+    template<class InputIterator>
+    void insert(InputIterator first, InputIterator last);
+
+    template<class... Args>
+    iterator emplace_hint(const iterator position, Args&&... args);
+    iterator find(const Key& key) const;
+    iterator lower_bound(const Key& key) const;
+    iterator upper_bound(const Key& key) const;
+    iterator erase(const iterator it);
+    size_type erase(const Key& key);
+
+    iterator begin() const;
+    iterator end() const;
+    bool empty() const;
+    size_type size() const;
+    void clear();
+    void seed(std::uint64_t value); // reseeds the level generator
+
+private:
+    static constexpr int levelLimit = 64;
+    static constexpr int minFill = BlockSize / 4; // blocks below this get merged with a neighbour
+
+    static Block* createBlock(int level);
+    static void destroyBlock(Block* block);
+    void init(); // sets up head and tail
+    void destroyBlocks();
+
+    int randomLevel();
+    bool goesBefore(Block* block, const Key& key, bool upper) const; // should the search move past @block ?
+    Block* findBlock(const Key& key, bool upper) const; // last block whose first key goes before @key (upper: does not go after), head if none
+    int position(Block* block, const Key& key, bool upper) const; // number of elts in @block going before @key (upper: not going after it)
+    iterator bound(const Key& key, bool upper) const;
+
+    void linkAfter(Block* newBlock, Block* left); // links @newBlock right behind @left on every level
+    void unlink(Block* block);
+    Block* split(Block* block); // moves the upper half of @block into a new block, returns it
+    iterator place(std::pair<Key, T>&& elt); // inserts @elt behind the elts with an equal key
+    iterator place(const iterator position, std::pair<Key, T>&& elt); // inserts @elt just before @position, if that keeps the list sorted
+    template<class K, class... Args>
+    std::pair<iterator, bool> tryEmplace(K&& key, Args&&... args);
+    void insertElt(Block* block, int index, std::pair<Key, T>&& elt);
+    void eraseElts(Block* block, int from, int to);
+    void syncKeys(Block* block, int from); // copies the keys of the elts [from, count) of @block into its key array
+    iterator rebalance(Block* block, int index); // frees/merges @block if it got too small, returns the iterator to (block, index)
+
+    const int maxHeight; // max num of levels ("height")
+    int currentHeight = 1; // current "height" of skip-list
+    size_type length = 0; // number of elts
+    Block* head; // head of skiplist
+    Block* tail; // tail of skiplist
+
+    Levels levels; // rolls the block heights
+};
+
+/** implementation **/
+
+template<typename Key, typename T, class Compare, int BlockSize, class Levels>
+UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::UnrolledSkipList(unsigned int maxHeight) : maxHeight(std::min<unsigned int>(std::max<unsigned int>(maxHeight, 1), levelLimit)) // initialises a skiplist with the specified level height
+{
+    init();
+}
+
+template<typename Key, typename T, class Compare, int BlockSize, class Levels>
+UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::~UnrolledSkipList()
+{
+    destroyBlocks();
+}
+
+template<typename Key, typename T, class Compare, int BlockSize, class Levels>
+void UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::init()
+{
+    head = createBlock(maxHeight - 1);
+    tail = createBlock(maxHeight - 1);
+
+    for (int i = 0; i != maxHeight; i++)
+    {
+        head->next()[i] = tail;
+        head->prev()[i] = NULL;
+        tail->next()[i] = NULL;
+        tail->prev()[i] = head;
+    }
+}
+
+template<typename Key, typename T, class Compare, int BlockSize, class Levels>
+void UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::destroyBlocks()
+{
+    Block* it = head;
+    while (it != NULL)
+    {
+        Block* next = it->next()[0];
+        eraseElts(it, 0, it->count);
+        destroyBlock(it);
+        it = next;
+    }
+}
+
+template<typename Key, typename T, class Compare, int BlockSize, class Levels>
+typename UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::Block* UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::createBlock(int level) // allocates an empty block, its tower and room for BlockSize elts in one go
+{
+    void* memory = ::operator new(Block::blockSize(level), std::align_val_t(64));
+    return new (memory) Block(level);
+}
+
+template<typename Key, typename T, class Compare, int BlockSize, class Levels>
+void UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::destroyBlock(Block* block) // the elts have to be destroyed already
+{
+    block->~Block();
+    ::operator delete(block, std::align_val_t(64));
+}
+
+template<typename Key, typename T, class Compare, int BlockSize, class Levels>
+int UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::randomLevel() // rolls the level of a new block
+{
+    int lvl = cappedLevel(levels, length / minFill, maxHeight); // capped by the block count (blocks are at least a quarter full)
+    if (lvl >= currentHeight)
+        currentHeight = lvl + 1;
+
+    return lvl;
+}
+
+template<typename Key, typename T, class Compare, int BlockSize, class Levels>
+bool UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::goesBefore(Block* block, const Key& key, bool upper) const
+{
+    if (block == tail)
+        return false;
+    if (upper)
+        return !Compare()(block->firstKey(), key); // first key <= key
+    return Compare()(key, block->firstKey()); // first key < key
+}
+
+template<typename Key, typename T, class Compare, int BlockSize, class Levels>
+typename UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::Block* UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::findBlock(const Key& key, bool upper) const
+{
+    Block* it = head; // our block iterator
+    // iterate over levels, from top to bottom
+    for (int i = currentHeight - 1; i >= 0; i--)
+    {
+        // iterate throught the current level, from left to right
+        for (; goesBefore(it->next()[i], key, upper); it = it->next()[i]);
+    }
+
+    return it;
+}
+
+template<typename Key, typename T, class Compare, int BlockSize, class Levels>
+int UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::position(Block* block, const Key& key, bool upper) const
+{
+    // dense keys ? --> count them in vectors, no branches to mispredict
+    if constexpr (denseKeys)
+        return KeySearch::countBefore(block->keys(), block->count, key, upper);
+
+    std::pair<Key, T>* elts = block->elts();
+    std::pair<Key, T>* found = std::partition_point(elts, elts + block->count, [&](const std::pair<Key, T>& elt)
+    {
+        return upper ? !Compare()(elt.first, key) : Compare()(key, elt.first);
+    });
+    return static_cast<int>(found - elts);
+}
+
+template<typename Key, typename T, class Compare, int BlockSize, class Levels>
+typename UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::iterator UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::bound(const Key& key, bool upper) const // lower (upper) bound: first elt whose key does not go before (goes after) @key
+{
+    Block* block = findBlock(key, upper);
+    if (block == head)
+        return iterator(head->next()[0], 0); // every block starts after @key, so the bound is the very first elt
+
+    // search inside the block
+    int index = position(block, key, upper);
+    if (index == block->count)
+        return iterator(block->next()[0], 0); // first elt of the next block
+    return iterator(block, index);
+}
+
+template<typename Key, typename T, class Compare, int BlockSize, class Levels>
+void UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::linkAfter(Block* newBlock, Block* left)
+{
+    Block* it = left;
+    for (int i = 0; i != newBlock->height; i++)
+    {
+        // climb to the last block (left of the insertion point) that is high enough
+        while (it->height <= i)
+            it = it->prev()[i - 1];
+
+        // rebind the pointers
+        newBlock->next()[i] = it->next()[i];
+        it->next()[i] = newBlock;
+
+        newBlock->prev()[i] = it;
+        newBlock->next()[i]->prev()[i] = newBlock;
+    }
+}
+
+template<typename Key, typename T, class Compare, int BlockSize, class Levels>
+void UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::unlink(Block* block)
+{
+    // rebind pointers
+    for (int i = 0; i != block->height; i++)
+    {
+        block->prev()[i]->next()[i] = block->next()[i];
+        block->next()[i]->prev()[i] = block->prev()[i];
+    }
+}
+
+template<typename Key, typename T, class Compare, int BlockSize, class Levels>
+typename UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::Block* UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::split(Block* block)
+{
+    Block* upperHalf = createBlock(randomLevel());
+    int half = block->count / 2;
+
+    std::pair<Key, T>* from = block->elts();
+    std::pair<Key, T>* to = upperHalf->elts();
+    for (int i = half; i != block->count; i++)
+    {
+        new (&to[i - half]) std::pair<Key, T>(std::move(from[i]));
+        from[i].~pair();
+    }
+    upperHalf->count = block->count - half;
+    block->count = half;
+    syncKeys(upperHalf, 0);
+
+    linkAfter(upperHalf, block);
+    return upperHalf;
+}
+
+template<typename Key, typename T, class Compare, int BlockSize, class Levels>
+void UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::insertElt(Block* block, int index, std::pair<Key, T>&& elt) // the block must not be full
+{
+    std::pair<Key, T>* elts = block->elts();
+    if (index == block->count)
+    {
+        new (&elts[index]) std::pair<Key, T>(std::move(elt));
+    }
+    else
+    {
+        // make room: the last elt moves into raw memory, the rest shifts by one
+        new (&elts[block->count]) std::pair<Key, T>(std::move(elts[block->count - 1]));
+        std::move_backward(elts + index, elts + block->count - 1, elts + block->count);
+        elts[index] = std::move(elt);
+    }
+
+    block->count++;
+    syncKeys(block, index);
+}
+
+template<typename Key, typename T, class Compare, int BlockSize, class Levels>
+void UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::eraseElts(Block* block, int from, int to) // erases the elts [from, to) of @block
+{
+    std::pair<Key, T>* elts = block->elts();
+    std::move(elts + to, elts + block->count, elts + from);
+    for (int i = block->count - (to - from); i != block->count; i++)
+        elts[i].~pair();
+
+    block->count -= to - from;
+    syncKeys(block, from);
+}
+
+template<typename Key, typename T, class Compare, int BlockSize, class Levels>
+void UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::syncKeys(Block* block, int from)
+{
+    if constexpr (denseKeys)
+    {
+        std::pair<Key, T>* elts = block->elts();
+        Key* keys = block->keys();
+        for (int i = from; i < block->count; i++)
+            keys[i] = elts[i].first;
+    }
+}
+
+template<typename Key, typename T, class Compare, int BlockSize, class Levels>
+typename UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::iterator UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::rebalance(Block* block, int index)
+{
+    // nothing left ? --> drop the block
+    if (block->count == 0)
+    {
+        Block* next = block->next()[0];
+        unlink(block);
+        destroyBlock(block);
+        return iterator(next, 0);
+    }
+
+    if (block->count < minFill)
+    {
+        Block* next = block->next()[0];
+        Block* prev = block->prev()[0];
+        Block* into = NULL; // block that absorbs the other one
+        Block* from = NULL;
+
+        if (next != tail && block->count + next->count <= BlockSize)
+        {
+            into = block;
+            from = next;
+        }
+        else if (prev != head && prev->count + block->count <= BlockSize)
+        {
+            into = prev;
+            from = block;
+            index += prev->count;
+            block = prev;
+        }
+
+        // merge
+        if (into != NULL)
+        {
+            std::pair<Key, T>* source = from->elts();
+            std::pair<Key, T>* target = into->elts() + into->count;
+            for (int i = 0; i != from->count; i++)
+            {
+                new (&target[i]) std::pair<Key, T>(std::move(source[i]));
+                source[i].~pair();
+            }
+            int merged = into->count;
+            into->count += from->count;
+            syncKeys(into, merged);
+
+            unlink(from);
+            destroyBlock(from);
+        }
+    }
+
+    if (index == block->count)
+        return iterator(block->next()[0], 0);
+    return iterator(block, index);
+}
+
+template<typename Key, typename T, class Compare, int BlockSize, class Levels>
+template<class... Args>
+typename UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::iterator UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::emplace(Args&&... args) // inserts a new elt (after the elts with an equal key)
+{
+    return place(std::pair<Key, T>(std::forward<Args>(args)...));
+}
+
+template<typename Key, typename T, class Compare, int BlockSize, class Levels>
+typename UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::iterator UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::place(std::pair<Key, T>&& elt)
+{
+    const Key& key = elt.first;
+    Block* block = findBlock(key, true);
+    if (block == head)
+        block = head->next()[0]; // goes before everything --> front of the first block
+
+    // empty list ? --> first block
+    if (block == tail)
+    {
+        block = createBlock(randomLevel());
+        linkAfter(block, head);
+    }
+
+    // position inside the block: behind the elts that do not go after @key
+    int index = position(block, key, true);
+
+    // no room ? --> split
+    if (block->count == BlockSize)
+    {
+        Block* upperHalf = split(block);
+        if (index > block->count)
+        {
+            index -= block->count;
+            block = upperHalf;
+        }
+    }
+
+    insertElt(block, index, std::move(elt));
+    length++;
+
+    return iterator(block, index);
+}
+
+// alias for emplace(pair)
+template<typename Key, typename T, class Compare, int BlockSize, class Levels>
+typename UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::iterator UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::insert(const std::pair<Key, T>& pair) // inserts a new elt
+{
+    return place(std::pair<Key, T>(pair));
+}
+
+template<typename Key, typename T, class Compare, int BlockSize, class Levels>
+typename UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::iterator UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::insert(std::pair<Key, T>&& pair) // inserts a new elt, the pair is moved in
+{
+    return place(std::move(pair));
+}
+
+// alias for emplace(key, value)
+template<typename Key, typename T, class Compare, int BlockSize, class Levels>
+typename UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::iterator UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::insert(const Key& key, const T& value) // inserts a new elt
+{
+    return emplace(key, value);
+}
+
+template<typename Key, typename T, class Compare, int BlockSize, class Levels>
+typename UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::iterator UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::insert(Key&& key, T&& value) // inserts a new elt, key and value are moved in
+{
+    return emplace(std::move(key), std::move(value));
+}
+
+// alias for emplace_hint(w/key, value)
+template<typename Key, typename T, class Compare, int BlockSize, class Levels>
+typename UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::iterator UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::insert(const iterator position, const Key& key, const T& value) // inserts a new elt
+{
+    return emplace_hint(position, key, value);
+}
+
+template<typename Key, typename T, class Compare, int BlockSize, class Levels>
+typename UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::iterator UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::insert(const iterator position, Key&& key, T&& value) // inserts a new elt
+{
+    return emplace_hint(position, std::move(key), std::move(value));
+}
+
+// alias for emplace_hint(w/pair)
+template<typename Key, typename T, class Compare, int BlockSize, class Levels>
+typename UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::iterator UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::insert(const iterator position, const std::pair<Key, T>& pair) // inserts a new elt
+{
+    return place(position, std::pair<Key, T>(pair));
+}
+
+template<typename Key, typename T, class Compare, int BlockSize, class Levels>
+typename UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::iterator UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::insert(const iterator position, std::pair<Key, T>&& pair) // inserts a new elt
+{
+    return place(position, std::move(pair));
+}
+
+template<typename Key, typename T, class Compare, int BlockSize, class Levels>
+template<class... Args>
+std::pair<typename UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::iterator, bool> UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::try_emplace(const Key& key, Args&&... args) // inserts (key, T(args...)) unless an elt with an equivalent key exists
+{
+    return tryEmplace(key, std::forward<Args>(args)...);
+}
+
+template<typename Key, typename T, class Compare, int BlockSize, class Levels>
+template<class... Args>
+std::pair<typename UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::iterator, bool> UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::try_emplace(Key&& key, Args&&... args) // same, @key is moved in
+{
+    return tryEmplace(std::move(key), std::forward<Args>(args)...);
+}
+
+template<typename Key, typename T, class Compare, int BlockSize, class Levels>
+template<class K, class... Args>
+std::pair<typename UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::iterator, bool> UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::tryEmplace(K&& key, Args&&... args) // returns the first elt with an equivalent key and false, or the new elt and true
+{
+    iterator it = bound(key, false);
+    if (it.block != tail && !Compare()(it->first, key))
+        return std::pair<iterator, bool>(it, false); // found --> nothing gets constructed
+
+    // the lower bound is the exact insertion point, so it is a hint that holds
+    return std::pair<iterator, bool>(place(it, std::pair<Key, T>(std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)), std::forward_as_tuple(std::forward<Args>(args)...))), true);
+}
+
+template<typename Key, typename T, class Compare, int BlockSize, class Levels>
+template<class InputIterator>
+void UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::insert(InputIterator first, InputIterator last) // range insert, sorted input gets appended to the last block without searching
+{
+    for (; first != last; ++first)
+    {
+        emplace_hint(end(), *first);
+    }
+}
+
+template<typename Key, typename T, class Compare, int BlockSize, class Levels>
+template<class... Args>
+typename UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::iterator UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::emplace_hint(const iterator position, Args&&... args) // inserts a new elt just before @position, if that keeps the list sorted
+{
+    return place(position, std::pair<Key, T>(std::forward<Args>(args)...));
+}
+
+template<typename Key, typename T, class Compare, int BlockSize, class Levels>
+typename UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::iterator UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::place(const iterator position, std::pair<Key, T>&& elt)
+{
+    const Key& key = elt.first;
+    Block* block = position.block;
+    int index = position.index;
+
+    // the elt in front of @position
+    Block* prevBlock = index != 0 ? block : block->prev()[0];
+    int prevIndex = index != 0 ? index - 1 : prevBlock->count - 1;
+
+    // is the given position invalid ? --> then we ignore the hint entirely
+    if (prevBlock == head || Compare()(prevBlock->elts()[prevIndex].first, key))
+        return place(std::move(elt));
+    if (block != tail && Compare()(key, block->elts()[index].first))
+        return place(std::move(elt));
+
+    // at the front of a block (or at the end) the elt can also go to the back of the previous block
+    if (index == 0 && prevBlock->count != BlockSize)
+    {
+        block = prevBlock;
+        index = prevBlock->count;
+    }
+    if (block == tail || block->count == BlockSize)
+        return place(std::move(elt)); // no room --> the regular insertion splits
+
+    insertElt(block, index, std::move(elt));
+    length++;
+
+    return iterator(block, index);
+}
+
+template<typename Key, typename T, class Compare, int BlockSize, class Levels>
+typename UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::iterator UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::find(const Key& key) const // returns an iterator to the first elt with a key equivalent to @key, end() otherwise
+{
+    iterator it = bound(key, false);
+    if (it.block == tail || Compare()(it->first, key))
+        return end();
+    return it;
+}
+
+template<typename Key, typename T, class Compare, int BlockSize, class Levels>
+typename UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::iterator UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::lower_bound(const Key& key) const // returns an iterator to the first elt whose key does not go before @key
+{
+    return bound(key, false);
+}
+
+template<typename Key, typename T, class Compare, int BlockSize, class Levels>
+typename UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::iterator UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::upper_bound(const Key& key) const // returns an iterator to the first elt whose key goes after @key
+{
+    return bound(key, true);
+}
+
+template<typename Key, typename T, class Compare, int BlockSize, class Levels>
+typename UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::iterator UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::erase(const iterator it) // removes the elt, returns an iterator to the next one
+{
+    eraseElts(it.block, it.index, it.index + 1);
+    length--;
+    return rebalance(it.block, it.index);
+}
+
+template<typename Key, typename T, class Compare, int BlockSize, class Levels>
+typename UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::size_type UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::erase(const Key& key) // removes all the elts with @key, returns the number of elts removed
+{
+    size_type count = 0;
+    iterator it = bound(key, false);
+
+    // remove the run of equal keys, one block at a time
+    while (it.block != tail && !Compare()(it->first, key))
+    {
+        std::pair<Key, T>* elts = it.block->elts();
+        int to = it.index;
+        while (to != it.block->count && !Compare()(elts[to].first, key))
+            to++;
+
+        eraseElts(it.block, it.index, to);
+        count += to - it.index;
+        it = rebalance(it.block, it.index);
+    }
+
+    length -= count;
+    return count;
+}
+
+template<typename Key, typename T, class Compare, int BlockSize, class Levels>
+typename UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::iterator UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::begin() const // return start iterator
+{
+    return iterator(head->next()[0], 0);
+}
+
+template<typename Key, typename T, class Compare, int BlockSize, class Levels>
+typename UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::iterator UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::end() const // return past-the-end iterator
+{
+    return iterator(tail, 0);
+}
+
+template<typename Key, typename T, class Compare, int BlockSize, class Levels>
+bool UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::empty() const // returns whether the container is empty
+{
+    return length == 0;
+}
+
+template<typename Key, typename T, class Compare, int BlockSize, class Levels>
+typename UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::size_type UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::size() const // returns the number of elts
+{
+    return length;
+}
+
+template<typename Key, typename T, class Compare, int BlockSize, class Levels>
+void UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::clear() // removes all elts
+{
+    destroyBlocks();
+    currentHeight = 1;
+    length = 0;
+    init();
+}
+
+template<typename Key, typename T, class Compare, int BlockSize, class Levels>
+void UnrolledSkipList<Key, T, Compare, BlockSize, Levels>::seed(std::uint64_t value)
+{
+    levels.seed(value);
+}
+
+#endif // UNROLLEDSKIPLIST_H
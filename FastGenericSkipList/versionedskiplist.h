@@ -0,0 +1,316 @@
+#ifndef VERSIONEDSKIPLIST_H
+#define VERSIONEDSKIPLIST_H
+
+#include <functional> // greater
+#include <iterator> // forward_iterator_tag
+#include <utility> // pair, forward, piecewise_construct
+#include <tuple> // forward_as_tuple
+#include <cstdint> // uint64_t
+#include <limits> // numeric_limits
+#include <set> // multiset
+#include <deque> // deque
+#include <mutex> // unique_lock
+#include <shared_mutex> // shared_mutex, shared_lock
+
+#include "skiplist.h"
+
+
+/*
+ * multi-version skip list (MVCC), built on SkipList
+ * every elt is a version stamped with the write that created it (born) and the one that erased it (died).
+ * snapshot() returns a read handle fixed at the current write: its searches and iterators see the list as it was
+ * then (born <= snapshot < died), however the writers go on. find and count only walk the versions with their key,
+ * the bounds and the iterators step over every hidden version in their way (the ones born after the snapshot too).
+ * erased versions stay linked as long as a snapshot can still see them and are reclaimed when the last such snapshot
+ * is released; versions no snapshot can see are unlinked right away.
+ *
+ * thread safety: writers (emplace, erase) take the lock exclusively, one operation at a time. snapshot searches and
+ * every iterator step take it shared, so a long scan only ever holds it for one step and never blocks the writers
+ * for its whole length. a view can be read from several threads at once (an iterator by one thread at a time).
+*/
+template <typename Key, typename T, class Compare = std::greater<Key> > class VersionedSkipList
+{
+private:
+    struct Version
+    {
+        Version() : value(), born(0) { } // head/tail of the list
+        template<class V>
+        Version(V&& value, std::uint64_t born) : value(std::forward<V>(value)), born(born) { }
+
+        T value;
+        std::uint64_t born; // write that created this version
+        std::uint64_t died = alive; // write that erased it
+    };
+
+    typedef SkipList<Key, Version, Compare> List;
+    static constexpr std::uint64_t alive = std::numeric_limits<std::uint64_t>::max();
+
+public:
+    typedef typename List::size_type size_type;
+    class view;
+
+    // iterator over the versions a snapshot sees (forward only), it must not outlive its view
+    class iterator
+    {
+        friend class VersionedSkipList;
+    private:
+        const VersionedSkipList* list;
+        std::uint64_t sequence;
+        typename List::iterator it;
+
+        iterator(const VersionedSkipList* list, std::uint64_t sequence, typename List::iterator it) : list(list), sequence(sequence), it(it) { }
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef std::pair<const Key&, const T&> value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef value_type reference;
+
+        struct pointer // lets it->first / it->second work on the pair of references
+        {
+            value_type pair;
+            const value_type* operator->() const { return &pair; }
+        };
+
+        iterator() : list(NULL), sequence(0) { }
+        value_type operator*() const { return value_type(it->first, it->second.value); } // the version can't go away while its view lives
+        pointer operator->() const { return pointer{ **this }; }
+        iterator& operator++()
+        {
+            std::shared_lock<std::shared_mutex> guard(list->lock);
+            ++it;
+            list->skipHidden(it, sequence);
+            return *this;
+        }
+        iterator operator++(int) { iterator old = *this; ++*this; return old; }
+        bool operator==(const iterator& other) const { return it == other.it; }
+        bool operator!=(const iterator& other) const { return it != other.it; }
+    };
+
+    // read handle returned by snapshot(), the list as it was when it was taken; released when destroyed
+    class view
+    {
+        friend class VersionedSkipList;
+    private:
+        VersionedSkipList* list;
+        std::uint64_t sequence;
+
+        view(VersionedSkipList* list, std::uint64_t sequence) : list(list), sequence(sequence) { }
+    public:
+        view(view&& other) : list(other.list), sequence(other.sequence) { other.list = NULL; }
+        view(const view&) = delete;
+        view& operator=(const view&) = delete;
+        ~view() { if (list != NULL) list->release(sequence); }
+
+        iterator begin() const;
+        iterator end() const;
+        iterator find(const Key& key) const;
+        iterator lower_bound(const Key& key) const;
+        iterator upper_bound(const Key& key) const;
+        size_type count(const Key& key) const;
+        std::uint64_t version() const { return sequence; } // number of writes the view sees
+    };
+
+    VersionedSkipList(unsigned int maxLevels = 32);
+    VersionedSkipList(const VersionedSkipList&) = delete;
+    VersionedSkipList& operator=(const VersionedSkipList&) = delete;
+
+    template<class K, class V>
+    void emplace(K&& key, V&& value); // a new version, visible to the snapshots taken from now on
+    void insert(const std::pair<Key, T>& pair);
+    size_type erase(const Key& key); // ends the live versions with @key, returns how many there were
+
+    view snapshot(); // views must be released before the list goes away
+    size_type size() const; // live elts
+    bool empty() const;
+    size_type versions() const; // elts stored, erased versions kept for snapshots included
+
+private:
+    static bool visible(const Version& version, std::uint64_t sequence) { return version.born <= sequence && sequence < version.died; }
+    void skipHidden(typename List::iterator& it, std::uint64_t sequence) const; // moves @it to the first version visible at @sequence (or end)
+    typename List::iterator search(const Key& key, bool upper, std::uint64_t sequence) const;
+    void release(std::uint64_t sequence); // a snapshot is gone, reclaims the versions nobody can see any more
+    void reclaim(); // unlinks the erased versions that died before the oldest snapshot
+
+    List list;
+    mutable std::shared_mutex lock;
+    std::uint64_t writes = 0; // stamp of the last write
+    size_type live = 0;
+    std::multiset<std::uint64_t> snapshots; // sequences of the snapshots alive
+    std::deque<std::pair<std::uint64_t, typename List::iterator> > erased; // versions kept for snapshots, in the order they died
+};
+
+/** implementation **/
+
+template<typename Key, typename T, class Compare>
+VersionedSkipList<Key, T, Compare>::VersionedSkipList(unsigned int maxLevels) : list(maxLevels)
+{
+}
+
+template<typename Key, typename T, class Compare>
+template<class K, class V>
+void VersionedSkipList<Key, T, Compare>::emplace(K&& key, V&& value)
+{
+    std::unique_lock<std::shared_mutex> guard(lock);
+    std::uint64_t born = writes + 1;
+    list.emplace(std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)), std::forward_as_tuple(std::forward<V>(value), born));
+    writes = born; // only once the version is in (emplace may throw)
+    live++;
+}
+
+template<typename Key, typename T, class Compare>
+void VersionedSkipList<Key, T, Compare>::insert(const std::pair<Key, T>& pair)
+{
+    emplace(pair.first, pair.second);
+}
+
+template<typename Key, typename T, class Compare>
+typename VersionedSkipList<Key, T, Compare>::size_type VersionedSkipList<Key, T, Compare>::erase(const Key& key)
+{
+    std::unique_lock<std::shared_mutex> guard(lock);
+    std::uint64_t died = writes + 1;
+    std::uint64_t newest = snapshots.empty() ? 0 : *snapshots.rbegin(); // versions born after it are seen by nobody
+    size_type count = 0;
+
+    typename List::iterator it = list.lower_bound(key);
+    while (it != list.end() && !Compare()(it->first, key))
+    {
+        if (it->second.died != alive)
+        {
+            ++it; // erased already, kept for a snapshot
+        }
+        else if (it->second.born > newest)
+        {
+            it = list.erase(it); // no snapshot can see it --> unlink right away
+            count++;
+        }
+        else
+        {
+            it->second.died = died;
+            erased.emplace_back(died, it);
+            ++it;
+            count++;
+        }
+    }
+
+    if (count != 0)
+    {
+        writes = died;
+        live -= count;
+    }
+    return count;
+}
+
+template<typename Key, typename T, class Compare>
+typename VersionedSkipList<Key, T, Compare>::view VersionedSkipList<Key, T, Compare>::snapshot()
+{
+    std::unique_lock<std::shared_mutex> guard(lock);
+    snapshots.insert(writes);
+    return view(this, writes);
+}
+
+template<typename Key, typename T, class Compare>
+void VersionedSkipList<Key, T, Compare>::release(std::uint64_t sequence)
+{
+    std::unique_lock<std::shared_mutex> guard(lock);
+    snapshots.erase(snapshots.find(sequence));
+    reclaim();
+}
+
+template<typename Key, typename T, class Compare>
+void VersionedSkipList<Key, T, Compare>::reclaim()
+{
+    // a version is visible to the snapshots in [born, died), the ones taken later see it erased
+    std::uint64_t oldest = snapshots.empty() ? alive : *snapshots.begin();
+    while (!erased.empty() && erased.front().first <= oldest)
+    {
+        list.erase(erased.front().second);
+        erased.pop_front();
+    }
+}
+
+template<typename Key, typename T, class Compare>
+void VersionedSkipList<Key, T, Compare>::skipHidden(typename List::iterator& it, std::uint64_t sequence) const
+{
+    for (; it != list.end() && !visible(it->second, sequence); ++it);
+}
+
+template<typename Key, typename T, class Compare>
+typename VersionedSkipList<Key, T, Compare>::List::iterator VersionedSkipList<Key, T, Compare>::search(const Key& key, bool upper, std::uint64_t sequence) const // first version visible at @sequence whose key does not go before (upper: goes after) @key
+{
+    std::shared_lock<std::shared_mutex> guard(lock);
+    typename List::iterator it = upper ? list.upper_bound(key) : list.lower_bound(key);
+    skipHidden(it, sequence);
+    return it;
+}
+
+template<typename Key, typename T, class Compare>
+typename VersionedSkipList<Key, T, Compare>::size_type VersionedSkipList<Key, T, Compare>::size() const
+{
+    std::shared_lock<std::shared_mutex> guard(lock);
+    return live;
+}
+
+template<typename Key, typename T, class Compare>
+bool VersionedSkipList<Key, T, Compare>::empty() const
+{
+    return size() == 0;
+}
+
+template<typename Key, typename T, class Compare>
+typename VersionedSkipList<Key, T, Compare>::size_type VersionedSkipList<Key, T, Compare>::versions() const
+{
+    std::shared_lock<std::shared_mutex> guard(lock);
+    return list.size();
+}
+
+/** view **/
+
+template<typename Key, typename T, class Compare>
+typename VersionedSkipList<Key, T, Compare>::iterator VersionedSkipList<Key, T, Compare>::view::begin() const
+{
+    std::shared_lock<std::shared_mutex> guard(list->lock);
+    typename List::iterator it = list->list.begin();
+    list->skipHidden(it, sequence);
+    return iterator(list, sequence, it);
+}
+
+template<typename Key, typename T, class Compare>
+typename VersionedSkipList<Key, T, Compare>::iterator VersionedSkipList<Key, T, Compare>::view::end() const
+{
+    return iterator(list, sequence, list->list.end()); // tail never moves
+}
+
+template<typename Key, typename T, class Compare>
+typename VersionedSkipList<Key, T, Compare>::iterator VersionedSkipList<Key, T, Compare>::view::find(const Key& key) const // first version with a key equivalent to @key, end() if none; only walks the versions with @key
+{
+    std::shared_lock<std::shared_mutex> guard(list->lock);
+    for (typename List::iterator it = list->list.lower_bound(key); it != list->list.end() && !Compare()(it->first, key); ++it)
+        if (visible(it->second, sequence))
+            return iterator(list, sequence, it);
+
+    return end();
+}
+
+template<typename Key, typename T, class Compare>
+typename VersionedSkipList<Key, T, Compare>::iterator VersionedSkipList<Key, T, Compare>::view::lower_bound(const Key& key) const
+{
+    return iterator(list, sequence, list->search(key, false, sequence));
+}
+
+template<typename Key, typename T, class Compare>
+typename VersionedSkipList<Key, T, Compare>::iterator VersionedSkipList<Key, T, Compare>::view::upper_bound(const Key& key) const
+{
+    return iterator(list, sequence, list->search(key, true, sequence));
+}
+
+template<typename Key, typename T, class Compare>
+typename VersionedSkipList<Key, T, Compare>::size_type VersionedSkipList<Key, T, Compare>::view::count(const Key& key) const // versions with @key the snapshot sees, O(log n + versions with @key)
+{
+    std::shared_lock<std::shared_mutex> guard(list->lock);
+    size_type count = 0;
+    for (typename List::iterator it = list->list.lower_bound(key); it != list->list.end() && !Compare()(it->first, key); ++it)
+        count += visible(it->second, sequence);
+    return count;
+}
+
+#endif // VERSIONEDSKIPLIST_H